@@ -0,0 +1,260 @@
+/**
+ * @file AllPairsTable.cpp
+ * @brief Parallel construction, incremental repair and table-walk queries
+ *        for AllPairsTable.
+ */
+
+#include "AllPairsTable.h"
+#include "SearchWorkspace.h"
+#include <thread>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <functional>
+
+namespace {
+const double INF = std::numeric_limits<double>::infinity();
+const uint32_t NONE = 0xFFFFFFFFu;
+
+typedef std::pair<double, uint32_t> QueueEntry;
+typedef std::vector<QueueEntry> Heap;
+
+void heapPush(Heap& heap, double dist, uint32_t node) {
+    heap.push_back(QueueEntry(dist, node));
+    std::push_heap(heap.begin(), heap.end(), std::greater<QueueEntry>());
+}
+
+QueueEntry heapPop(Heap& heap) {
+    std::pop_heap(heap.begin(), heap.end(), std::greater<QueueEntry>());
+    QueueEntry top = heap.back();
+    heap.pop_back();
+    return top;
+}
+}
+
+// Constructor
+AllPairsTable::AllPairsTable() : nodeCount_(0), buildMillis_(0.0), threadsUsed_(0) {
+}
+
+// One Dijkstra per source in this worker's share of rows
+void AllPairsTable::fillRows(const CSRGraph<Location*>& graph, uint32_t first, uint32_t stride) {
+    SearchWorkspace ws;
+
+    for (uint32_t s = first; s < nodeCount_; s += stride) {
+        double* distRow = &distances_[static_cast<size_t>(s) * nodeCount_];
+        uint32_t* parentRow = &parent_[static_cast<size_t>(s) * nodeCount_];
+
+        ws.begin(nodeCount_);
+        ws.setDistance(s, 0.0, NONE);
+        ws.push(0.0, s);
+        while (!ws.empty()) {
+            SearchWorkspace::QueueEntry top = ws.pop();
+            if (ws.isSettled(top.second)) continue;
+            ws.settle(top.second);
+            distRow[top.second] = top.first;
+            parentRow[top.second] = ws.previous(top.second);
+            for (const CSREdge& e : graph.neighbors(top.second)) {
+                if (ws.relax(e.target, top.first + e.weight, top.second)) {
+                    ws.push(top.first + e.weight, e.target);
+                }
+            }
+        }
+    }
+}
+
+// Build the table using all hardware threads
+void AllPairsTable::build(const CSRGraph<Location*>& graph, unsigned threads) {
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    nodeCount_ = graph.getNodeCount();
+    distances_.assign(nodeCount_ * nodeCount_, INF);
+    parent_.assign(nodeCount_ * nodeCount_, NONE);
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(1, nodeCount_)));
+    threadsUsed_ = threads;
+
+    // Rows are disjoint, so workers write without synchronisation
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.push_back(std::thread(&AllPairsTable::fillRows, this, std::cref(graph), t, threads));
+    }
+    fillRows(graph, 0, threads);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    buildMillis_ = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - started).count();
+}
+
+// Whether the table has been built
+bool AllPairsTable::empty() const {
+    return nodeCount_ == 0;
+}
+
+// Table lookup
+double AllPairsTable::distance(uint32_t source, uint32_t target) const {
+    return distances_[static_cast<size_t>(source) * nodeCount_ + target];
+}
+
+// Walk tree parents back from target, then reverse
+bool AllPairsTable::walk(uint32_t source, uint32_t target, std::vector<uint32_t>& nodes) const {
+    nodes.clear();
+    if (distance(source, target) == INF) {
+        return false;
+    }
+    const uint32_t* parentRow = &parent_[static_cast<size_t>(source) * nodeCount_];
+    uint32_t current = target;
+    nodes.push_back(current);
+    // Bounded by N steps as a guard against a corrupted tree
+    for (size_t steps = 0; current != source && steps < nodeCount_; ++steps) {
+        current = parentRow[current];
+        if (current == NONE) {
+            nodes.clear();
+            return false;
+        }
+        nodes.push_back(current);
+    }
+    std::reverse(nodes.begin(), nodes.end());
+    return current == source;
+}
+
+/**
+ * @brief Edge closure repair
+ *
+ * In row s the edge matters only if parent[to] == from. Then exactly the
+ * nodes whose tree path runs through to (the subtree T) can get longer.
+ * T is found by walking parent chains with memoisation (O(N) per row).
+ * Every node in T is reset, seeded from in-neighbours outside T (whose
+ * distances are still exact), and a Dijkstra restricted to T settles them.
+ */
+TableRepairStats AllPairsTable::edgeClosed(const CSRGraph<Location*>& graph,
+                                           uint32_t from, uint32_t to) {
+    TableRepairStats stats;
+    enum Mark : uint8_t { UNKNOWN = 0, INSIDE = 1, OUTSIDE = 2 };
+    std::vector<uint8_t> mark(nodeCount_);
+    std::vector<uint32_t> chain;
+    std::vector<uint32_t> subtree;
+    Heap heap;
+
+    for (size_t s = 0; s < nodeCount_; ++s) {
+        double* distRow = &distances_[s * nodeCount_];
+        uint32_t* parentRow = &parent_[s * nodeCount_];
+        if (to == s || parentRow[to] != from) {
+            continue;
+        }
+
+        // Classify every node: below `to` in the tree or not
+        std::fill(mark.begin(), mark.end(), static_cast<uint8_t>(UNKNOWN));
+        mark[to] = INSIDE;
+        mark[s] = OUTSIDE;
+        subtree.clear();
+        subtree.push_back(to);
+        for (uint32_t x = 0; x < nodeCount_; ++x) {
+            chain.clear();
+            uint32_t y = x;
+            while (mark[y] == UNKNOWN) {
+                chain.push_back(y);
+                y = parentRow[y];
+                if (y == NONE) break;
+            }
+            uint8_t verdict = (y == NONE) ? static_cast<uint8_t>(OUTSIDE) : mark[y];
+            for (uint32_t c : chain) {
+                mark[c] = verdict;
+                if (verdict == INSIDE) subtree.push_back(c);
+            }
+        }
+
+        // Cut the subtree off and seed it from the rest of the tree
+        for (uint32_t x : subtree) {
+            distRow[x] = INF;
+            parentRow[x] = NONE;
+        }
+        heap.clear();
+        for (uint32_t x : subtree) {
+            for (const CSREdge& e : graph.incoming(x)) {
+                if (mark[e.target] == OUTSIDE && distRow[e.target] + e.weight < distRow[x]) {
+                    distRow[x] = distRow[e.target] + e.weight;
+                    parentRow[x] = e.target;
+                }
+            }
+            if (distRow[x] < INF) heapPush(heap, distRow[x], x);
+        }
+
+        // Dijkstra inside the subtree only
+        while (!heap.empty()) {
+            QueueEntry top = heapPop(heap);
+            if (top.first > distRow[top.second]) continue;
+            for (const CSREdge& e : graph.neighbors(top.second)) {
+                if (mark[e.target] != INSIDE) continue;
+                double candidate = top.first + e.weight;
+                if (candidate < distRow[e.target]) {
+                    distRow[e.target] = candidate;
+                    parentRow[e.target] = top.second;
+                    heapPush(heap, candidate, e.target);
+                }
+            }
+        }
+
+        ++stats.rowsRepaired;
+        stats.nodesResettled += subtree.size();
+    }
+    return stats;
+}
+
+/**
+ * @brief Edge reopening repair
+ *
+ * A new edge can only shorten paths. Rows where it does not improve
+ * d(s, to) are untouched; otherwise a Dijkstra from `to` pushes the
+ * improvement outwards and stops where distances no longer drop.
+ */
+TableRepairStats AllPairsTable::edgeOpened(const CSRGraph<Location*>& graph,
+                                           uint32_t from, uint32_t to, double weight) {
+    TableRepairStats stats;
+    Heap heap;
+    for (size_t s = 0; s < nodeCount_; ++s) {
+        double* distRow = &distances_[s * nodeCount_];
+        uint32_t* parentRow = &parent_[s * nodeCount_];
+        if (!(distRow[from] + weight < distRow[to])) {
+            continue;
+        }
+
+        distRow[to] = distRow[from] + weight;
+        parentRow[to] = from;
+        heap.clear();
+        heapPush(heap, distRow[to], to);
+        while (!heap.empty()) {
+            QueueEntry top = heapPop(heap);
+            if (top.first > distRow[top.second]) continue;
+            ++stats.nodesResettled;
+            for (const CSREdge& e : graph.neighbors(top.second)) {
+                double candidate = top.first + e.weight;
+                if (candidate < distRow[e.target]) {
+                    distRow[e.target] = candidate;
+                    parentRow[e.target] = top.second;
+                    heapPush(heap, candidate, e.target);
+                }
+            }
+        }
+        ++stats.rowsRepaired;
+    }
+    return stats;
+}
+
+// Memory held by the table
+size_t AllPairsTable::getMemoryBytes() const {
+    return distances_.capacity() * sizeof(double) + parent_.capacity() * sizeof(uint32_t);
+}
+
+// Build time
+double AllPairsTable::getBuildMillis() const {
+    return buildMillis_;
+}
+
+// Threads used
+unsigned AllPairsTable::getThreadsUsed() const {
+    return threadsUsed_;
+}
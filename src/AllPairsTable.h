@@ -0,0 +1,131 @@
+/**
+ * @file AllPairsTable.h
+ * @brief Precomputed all-pairs distance and shortest-path-tree table.
+ *
+ * For small graphs (the built-in campus has a few dozen nodes) an N x N
+ * table is tiny and turns every query into a walk along tree parents, i.e.
+ * O(path length). Row s holds the shortest-path tree rooted at s (distance
+ * and parent of every node). The table is filled with one Dijkstra per
+ * source, with sources spread across all hardware threads. Memory grows as
+ * N^2, so getMemoryBytes() and getBuildMillis() are exposed to judge when
+ * the mode stops paying off.
+ *
+ * When an edge is closed or reopened the trees are repaired in place:
+ * a closure only touches rows whose tree uses the edge, and within such a
+ * row only the subtree hanging below it is re-settled.
+ */
+
+#ifndef ALL_PAIRS_TABLE_H
+#define ALL_PAIRS_TABLE_H
+
+#include "Location.h"
+#include "CSRGraph.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @struct TableRepairStats
+ * @brief Work done by an incremental table repair
+ */
+struct TableRepairStats {
+    size_t rowsRepaired;        ///< Trees that actually changed
+    size_t nodesResettled;      ///< Tree nodes whose distance was recomputed
+
+    TableRepairStats() : rowsRepaired(0), nodesResettled(0) {}
+};
+
+/**
+ * @class AllPairsTable
+ * @brief Row-major N x N distances and tree parents over dense node indices
+ */
+class AllPairsTable {
+private:
+    size_t nodeCount_;                  ///< N
+    std::vector<double> distances_;     ///< distances_[s * N + t]
+    std::vector<uint32_t> parent_;      ///< Node before t on the path s -> t
+    double buildMillis_;                ///< Wall-clock build time
+    unsigned threadsUsed_;              ///< Worker threads used by build()
+
+    /**
+     * @brief Fill rows for sources first, first + stride, ...
+     */
+    void fillRows(const CSRGraph<Location*>& graph, uint32_t first, uint32_t stride);
+
+public:
+    /**
+     * @brief Constructor (empty table)
+     */
+    AllPairsTable();
+
+    /**
+     * @brief Compute the table
+     * @param graph Frozen graph
+     * @param threads Worker threads (0 = all hardware threads)
+     */
+    void build(const CSRGraph<Location*>& graph, unsigned threads = 0);
+
+    /**
+     * @brief Whether build() has been run
+     */
+    bool empty() const;
+
+    /**
+     * @brief Shortest distance between two nodes
+     * @return Distance, or infinity if unreachable
+     */
+    double distance(uint32_t source, uint32_t target) const;
+
+    /**
+     * @brief Repair every tree after the edges from -> to became unusable
+     * @param graph Routing graph in which from -> to now has infinite weight
+     * @param from Edge tail
+     * @param to Edge head
+     * @return Rows and nodes touched
+     * 
+     * Rows whose tree does not use from -> to are skipped in O(1). In the
+     * others, the subtree below to is cut off and re-attached by a Dijkstra
+     * seeded from its unaffected in-neighbours, restricted to the subtree.
+     */
+    TableRepairStats edgeClosed(const CSRGraph<Location*>& graph, uint32_t from, uint32_t to);
+
+    /**
+     * @brief Repair every tree after an edge from -> to became available
+     * @param graph Routing graph containing the edge
+     * @param from Edge tail
+     * @param to Edge head
+     * @param weight Edge weight
+     * @return Rows and nodes touched
+     * 
+     * Only rows where d(s, from) + weight improves d(s, to) change; from
+     * there a Dijkstra propagates the decrease.
+     */
+    TableRepairStats edgeOpened(const CSRGraph<Location*>& graph, uint32_t from, uint32_t to,
+                                double weight);
+
+    /**
+     * @brief Walk tree parents from target back to source
+     * @param source Dense start index
+     * @param target Dense end index
+     * @param nodes Output: node sequence including both endpoints
+     * @return False if target is unreachable
+     */
+    bool walk(uint32_t source, uint32_t target, std::vector<uint32_t>& nodes) const;
+
+    /**
+     * @brief Bytes held by the distance and parent arrays
+     */
+    size_t getMemoryBytes() const;
+
+    /**
+     * @brief Build time in milliseconds
+     */
+    double getBuildMillis() const;
+
+    /**
+     * @brief Worker threads used by the last build
+     */
+    unsigned getThreadsUsed() const;
+};
+
+#endif // ALL_PAIRS_TABLE_H
@@ -0,0 +1,364 @@
+/**
+ * @file CSRGraph.h
+ * @brief Frozen compressed sparse row (CSR) form of Graph<T>.
+ *
+ * The mutable Graph<T> keeps one heap-allocated edge vector per node inside
+ * a std::map, which is convenient for editing but slow to scan. CSRGraph
+ * copies that adjacency into two contiguous arrays (offsets and edges) so
+ * that a neighbor scan is a linear walk over adjacent memory. Nodes are
+ * addressed by a dense index 0..N-1; the original node values are kept for
+ * translating back at the API boundary.
+ *
+ * A transposed copy of the edges (incoming adjacency) is built alongside so
+ * backward searches can walk edges against their direction; Graph::addEdge
+ * allows directed edges, so the two are not in general the same.
+ *
+ * The arrays can also live outside the object, e.g. in a memory-mapped
+ * GraphSnapshot: the graph then reads them in place and only copies them
+ * if an edge weight is changed.
+ */
+
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include "Graph.h"
+#include <map>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+
+/**
+ * @struct CSREdge
+ * @brief Edge stored in the contiguous CSR edge array
+ */
+struct CSREdge {
+    uint32_t target;    ///< Dense index of the destination node
+    double weight;      ///< Edge weight (distance)
+};
+
+/**
+ * @struct CSRArrays
+ * @brief Pointers to the five CSR arrays, wherever they are stored
+ */
+struct CSRArrays {
+    const uint32_t* offsets;        ///< nodeCount + 1 entries
+    const CSREdge* edges;           ///< edgeCount entries
+    const uint32_t* inOffsets;      ///< nodeCount + 1 entries
+    const CSREdge* inEdges;         ///< edgeCount entries
+    const uint32_t* inPosition;     ///< edgeCount entries
+    size_t nodeCount;
+    size_t edgeCount;
+};
+
+/**
+ * @class CSRGraph
+ * @brief Read-only compressed sparse row snapshot of a Graph<T>
+ *
+ * Example usage:
+ * @code
+ * CSRGraph<Location*> csr(campusGraph);
+ * uint32_t u = csr.indexOf(loc);
+ * for (const CSREdge& e : csr.neighbors(u)) { ... }
+ * @endcode
+ */
+template<typename T>
+class CSRGraph {
+public:
+    /**
+     * @struct NeighborRange
+     * @brief Non-owning [begin, end) view over one node's edges
+     */
+    struct NeighborRange {
+        const CSREdge* first;
+        const CSREdge* last;
+
+        const CSREdge* begin() const { return first; }
+        const CSREdge* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+private:
+    std::vector<T> nodes_;              ///< Dense index -> node
+    std::map<T, uint32_t> indices_;     ///< Node -> dense index
+    std::vector<uint32_t> offsets_;     ///< Edge range of node i is [offsets_[i], offsets_[i+1])
+    std::vector<CSREdge> edges_;        ///< All edges, grouped by source node
+    std::vector<uint32_t> inOffsets_;   ///< Incoming edge range of node i
+    std::vector<CSREdge> inEdges_;      ///< Reversed edges, grouped by destination (target = source)
+    std::vector<uint32_t> inPosition_;  ///< Edge id -> position of its reversed copy in inEdges_
+    CSRArrays external_;                ///< Arrays read in place when storage_ is set
+    std::shared_ptr<const void> storage_; ///< Keeps external arrays alive (null = own vectors)
+    
+    const uint32_t* offsetData() const { return storage_ ? external_.offsets : offsets_.data(); }
+    const CSREdge* edgeData() const { return storage_ ? external_.edges : edges_.data(); }
+    const uint32_t* inOffsetData() const { return storage_ ? external_.inOffsets : inOffsets_.data(); }
+    const CSREdge* inEdgeData() const { return storage_ ? external_.inEdges : inEdges_.data(); }
+    
+    // Copy external arrays into the own vectors before the first write
+    void detach() {
+        if (!storage_) {
+            return;
+        }
+        const CSRArrays& a = external_;
+        offsets_.assign(a.offsets, a.offsets + a.nodeCount + 1);
+        edges_.assign(a.edges, a.edges + a.edgeCount);
+        inOffsets_.assign(a.inOffsets, a.inOffsets + a.nodeCount + 1);
+        inEdges_.assign(a.inEdges, a.inEdges + a.edgeCount);
+        inPosition_.assign(a.inPosition, a.inPosition + a.edgeCount);
+        storage_.reset();
+    }
+
+    template<typename W>
+    void build(const Graph<T, W>& graph, const std::vector<T>& order) {
+        storage_.reset();
+        nodes_.clear();
+        indices_.clear();
+        offsets_.clear();
+        edges_.clear();
+        inOffsets_.clear();
+        inEdges_.clear();
+        inPosition_.clear();
+
+        nodes_.reserve(order.size());
+        for (const T& node : order) {
+            if (!graph.hasNode(node) || indices_.count(node)) {
+                continue;
+            }
+            indices_[node] = static_cast<uint32_t>(nodes_.size());
+            nodes_.push_back(node);
+        }
+        // Nodes present in the graph but missing from the requested order
+        // are appended so the snapshot always covers the whole graph.
+        for (const T& node : graph.getAllNodes()) {
+            if (!indices_.count(node)) {
+                indices_[node] = static_cast<uint32_t>(nodes_.size());
+                nodes_.push_back(node);
+            }
+        }
+
+        offsets_.reserve(nodes_.size() + 1);
+        edges_.reserve(graph.getEdgeCount());
+        offsets_.push_back(0);
+        for (const T& node : nodes_) {
+            for (const Edge<T, W>& edge : graph.neighbors(node)) {
+                CSREdge e;
+                e.target = indices_.at(edge.destination);
+                e.weight = static_cast<double>(edge.weight);
+                edges_.push_back(e);
+            }
+            offsets_.push_back(static_cast<uint32_t>(edges_.size()));
+        }
+
+        // Transpose with a counting sort: count in-degrees, prefix-sum, scatter
+        inOffsets_.assign(nodes_.size() + 1, 0);
+        for (const CSREdge& e : edges_) {
+            ++inOffsets_[e.target + 1];
+        }
+        for (size_t i = 1; i < inOffsets_.size(); ++i) {
+            inOffsets_[i] += inOffsets_[i - 1];
+        }
+        inEdges_.resize(edges_.size());
+        inPosition_.resize(edges_.size());
+        std::vector<uint32_t> cursor(inOffsets_.begin(), inOffsets_.end() - 1);
+        for (uint32_t u = 0; u < nodes_.size(); ++u) {
+            for (uint32_t k = offsets_[u]; k < offsets_[u + 1]; ++k) {
+                CSREdge reversed;
+                reversed.target = u;
+                reversed.weight = edges_[k].weight;
+                inPosition_[k] = cursor[edges_[k].target];
+                inEdges_[cursor[edges_[k].target]++] = reversed;
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Default constructor (empty graph)
+     */
+    CSRGraph() : offsets_(1, 0), inOffsets_(1, 0), external_() {}
+
+    /**
+     * @brief Freeze a graph, numbering nodes in Graph::getAllNodes() order
+     * @param graph Mutable graph to copy (any stored weight type)
+     */
+    template<typename W>
+    explicit CSRGraph(const Graph<T, W>& graph) : external_() {
+        build(graph, graph.getAllNodes());
+    }
+
+    /**
+     * @brief Freeze a graph using a caller-supplied node numbering
+     * @param graph Mutable graph to copy
+     * @param order Preferred node order; node order[i] gets index i
+     */
+    template<typename W>
+    CSRGraph(const Graph<T, W>& graph, const std::vector<T>& order) : external_() {
+        build(graph, order);
+    }
+    
+    /**
+     * @brief Wrap CSR arrays stored elsewhere without copying them
+     * @param nodes Node values; nodes[i] gets index i
+     * @param arrays CSR arrays for nodes.size() nodes
+     * @param storage Owner of the arrays, kept alive as long as this graph uses them
+     * @throws std::invalid_argument if the node count does not match the arrays
+     */
+    CSRGraph(const std::vector<T>& nodes, const CSRArrays& arrays,
+             std::shared_ptr<const void> storage)
+        : nodes_(nodes), external_(arrays), storage_(storage) {
+        if (nodes.size() != arrays.nodeCount) {
+            throw std::invalid_argument("CSR arrays do not match the node count");
+        }
+        for (uint32_t i = 0; i < nodes_.size(); ++i) {
+            indices_[nodes_[i]] = i;
+        }
+    }
+
+    /**
+     * @brief Get number of nodes
+     * @return Number of nodes
+     */
+    size_t getNodeCount() const {
+        return nodes_.size();
+    }
+
+    /**
+     * @brief Get number of edges
+     * @return Number of directed edges
+     */
+    size_t getEdgeCount() const {
+        return storage_ ? external_.edgeCount : edges_.size();
+    }
+    
+    /**
+     * @brief Check whether the arrays are read in place from external storage
+     * @return True until the first setEdgeWeight() on a wrapped graph
+     */
+    bool isExternal() const {
+        return static_cast<bool>(storage_);
+    }
+    
+    /**
+     * @brief Get pointers to the CSR arrays (e.g. to write them to a file)
+     * @return Arrays valid until the graph is modified or destroyed
+     */
+    CSRArrays getArrays() const {
+        CSRArrays arrays;
+        arrays.offsets = offsetData();
+        arrays.edges = edgeData();
+        arrays.inOffsets = inOffsetData();
+        arrays.inEdges = inEdgeData();
+        arrays.inPosition = storage_ ? external_.inPosition : inPosition_.data();
+        arrays.nodeCount = nodes_.size();
+        arrays.edgeCount = getEdgeCount();
+        return arrays;
+    }
+
+    /**
+     * @brief Check whether a node is part of the snapshot
+     * @param node Node to check
+     * @return True if present
+     */
+    bool hasNode(const T& node) const {
+        return indices_.find(node) != indices_.end();
+    }
+
+    /**
+     * @brief Get the dense index of a node
+     * @param node Node to look up
+     * @return Index in [0, getNodeCount())
+     * @throws std::out_of_range if the node is not in the snapshot
+     */
+    uint32_t indexOf(const T& node) const {
+        auto it = indices_.find(node);
+        if (it == indices_.end()) {
+            throw std::out_of_range("Node not found in CSR graph");
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief Get the node stored at a dense index
+     * @param index Dense node index
+     * @return Node value
+     */
+    const T& nodeAt(uint32_t index) const {
+        return nodes_[index];
+    }
+
+    /**
+     * @brief Get the outgoing edges of a node
+     * @param index Dense node index
+     * @return Contiguous range of edges
+     */
+    NeighborRange neighbors(uint32_t index) const {
+        const uint32_t* offsets = offsetData();
+        const CSREdge* base = edgeData();
+        NeighborRange range = { base + offsets[index], base + offsets[index + 1] };
+        return range;
+    }
+
+    /**
+     * @brief Get the global id of the first outgoing edge of a node
+     * @param index Dense node index
+     * @return Edge id; the k-th edge of neighbors(index) has id edgeBegin(index) + k
+     * 
+     * Edge ids lie in [0, getEdgeCount()) and let callers keep per-edge
+     * data (e.g. penalties) in flat arrays.
+     */
+    uint32_t edgeBegin(uint32_t index) const {
+        return offsetData()[index];
+    }
+
+    /**
+     * @brief Change the weight of one edge in place (forward and reversed copy)
+     * @param edgeId Edge id (see edgeBegin)
+     * @param weight New weight; infinity makes the edge unusable
+     * 
+     * Topology is unchanged, so this is O(1). Used for temporary closures
+     * without re-freezing the graph. A graph reading external arrays
+     * copies them first, leaving the external storage untouched.
+     */
+    void setEdgeWeight(uint32_t edgeId, double weight) {
+        detach();
+        edges_[edgeId].weight = weight;
+        inEdges_[inPosition_[edgeId]].weight = weight;
+    }
+
+    /**
+     * @brief Get the incoming edges of a node
+     * @param index Dense node index
+     * @return Range of reversed edges; each target is the edge's source node
+     */
+    NeighborRange incoming(uint32_t index) const {
+        const uint32_t* offsets = inOffsetData();
+        const CSREdge* base = inEdgeData();
+        NeighborRange range = { base + offsets[index], base + offsets[index + 1] };
+        return range;
+    }
+
+    /**
+     * @brief Get the out-degree of a node
+     * @param index Dense node index
+     * @return Number of outgoing edges
+     */
+    size_t degree(uint32_t index) const {
+        const uint32_t* offsets = offsetData();
+        return offsets[index + 1] - offsets[index];
+    }
+
+    /**
+     * @brief Approximate memory used by the CSR arrays
+     * @return Size in bytes (excluding the node -> index lookup map and
+     *         external arrays, which are not owned)
+     */
+    size_t memoryBytes() const {
+        return nodes_.capacity() * sizeof(T) +
+               (offsets_.capacity() + inOffsets_.capacity() + inPosition_.capacity()) * sizeof(uint32_t) +
+               (edges_.capacity() + inEdges_.capacity()) * sizeof(CSREdge);
+    }
+};
+
+#endif // CSR_GRAPH_H
@@ -0,0 +1,992 @@
+/**
+ * @file CampusDataLoader.cpp
+ * @brief Implementation of the streaming CSV / GeoJSON campus loader.
+ */
+
+#include "CampusDataLoader.h"
+#include "Location.h"
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <cmath>
+#include <algorithm>
+
+using CampusData::BuildingInfo;
+using CampusData::PathConnection;
+
+namespace {
+
+// Bytes read from the stream at a time
+const size_t BUFFER_SIZE = 1 << 16;
+
+// Nesting limit for JSON values, so hostile input cannot exhaust the stack
+const int MAX_JSON_DEPTH = 64;
+
+// Longest CSV record kept in memory; a stray quote would otherwise pull
+// the rest of the file into one field
+const size_t MAX_CSV_RECORD = 1 << 16;
+
+/**
+ * @class CharSource
+ * @brief Buffered character reader that counts lines
+ */
+class CharSource {
+private:
+    std::istream& in_;
+    std::vector<char> buffer_;
+    size_t pos_;
+    size_t end_;
+    size_t line_;
+    int last_;      ///< Last character returned by get()
+
+    bool fill() {
+        if (!in_) {
+            return false;
+        }
+        in_.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        end_ = static_cast<size_t>(in_.gcount());
+        pos_ = 0;
+        return end_ > 0;
+    }
+
+public:
+    explicit CharSource(std::istream& in)
+        : in_(in), buffer_(BUFFER_SIZE), pos_(0), end_(0), line_(1), last_('\n') {
+        // Skip a UTF-8 byte order mark
+        if (fill() && end_ >= 3 && static_cast<unsigned char>(buffer_[0]) == 0xEF &&
+            static_cast<unsigned char>(buffer_[1]) == 0xBB &&
+            static_cast<unsigned char>(buffer_[2]) == 0xBF) {
+            pos_ = 3;
+        }
+    }
+
+    int peek() {
+        if (pos_ == end_ && !fill()) {
+            return EOF;
+        }
+        return static_cast<unsigned char>(buffer_[pos_]);
+    }
+
+    int get() {
+        int c = peek();
+        if (c != EOF) {
+            ++pos_;
+            if (c == '\n') {
+                ++line_;
+            }
+            last_ = c;
+        }
+        return c;
+    }
+
+    size_t line() const {
+        return line_;
+    }
+
+    // Lines seen so far, counting an unterminated last line
+    size_t linesRead() const {
+        return last_ == '\n' ? line_ - 1 : line_;
+    }
+};
+
+// Record a rejected record
+void addIssue(LoadReport& report, size_t line, const std::string& message) {
+    ++report.errorCount;
+    if (report.errors.size() < CampusDataLoader::MAX_REPORTED_ERRORS) {
+        LoadIssue issue = { line, message };
+        report.errors.push_back(issue);
+    }
+}
+
+// Strict decimal parse of a whole field (surrounding spaces allowed)
+bool parseDouble(const std::string& text, double& value) {
+    const char* begin = text.c_str();
+    while (*begin == ' ' || *begin == '\t') ++begin;
+    if (*begin == '\0') {
+        return false;
+    }
+    char* end = nullptr;
+    value = std::strtod(begin, &end);
+    while (*end == ' ' || *end == '\t') ++end;
+    return *end == '\0' && std::isfinite(value);
+}
+
+// Lowercase alphanumerics only: "Distance_Meters" -> "distancemeters"
+std::string normalizeKey(const std::string& text) {
+    std::string key;
+    for (char c : text) {
+        if (std::isalnum(static_cast<unsigned char>(c))) {
+            key.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+        }
+    }
+    return key;
+}
+
+// Shared checks for both formats; empty string when valid
+std::string checkBuilding(const BuildingInfo& b) {
+    if (b.name.empty()) return "building has no name";
+    if (!(b.latitude >= -90.0 && b.latitude <= 90.0)) return "latitude out of range";
+    if (!(b.longitude >= -180.0 && b.longitude <= 180.0)) return "longitude out of range";
+    return std::string();
+}
+
+std::string checkPath(const PathConnection& p) {
+    if (p.from.empty() || p.to.empty()) return "path needs both from and to";
+    if (!(p.distanceMeters >= 0.0)) return "distance must be zero or positive";
+    return std::string();
+}
+
+/**
+ * @struct CsvColumns
+ * @brief Column index of every known field (-1 if absent)
+ */
+struct CsvColumns {
+    int kind, name, latitude, longitude, description, type, from, to, distance;
+
+    CsvColumns()
+        : kind(-1), name(-1), latitude(-1), longitude(-1), description(-1), type(-1),
+          from(-1), to(-1), distance(-1) {}
+
+    void assign(const std::string& header, int index) {
+        const std::string key = normalizeKey(header);
+        int* slot = nullptr;
+        if (key == "kind" || key == "record") slot = &kind;
+        else if (key == "name") slot = &name;
+        else if (key == "latitude" || key == "lat") slot = &latitude;
+        else if (key == "longitude" || key == "lon" || key == "lng") slot = &longitude;
+        else if (key == "description" || key == "desc") slot = &description;
+        else if (key == "type" || key == "buildingtype" || key == "category") slot = &type;
+        else if (key == "from" || key == "source") slot = &from;
+        else if (key == "to" || key == "target") slot = &to;
+        else if (key == "distance" || key == "distancemeters" || key == "distancem" ||
+                 key == "length") slot = &distance;
+        if (slot != nullptr && *slot < 0) {
+            *slot = index;
+        }
+    }
+
+    bool hasBuildings() const { return name >= 0 && latitude >= 0 && longitude >= 0; }
+    bool hasPaths() const { return from >= 0 && to >= 0; }
+};
+
+/**
+ * @enum CsvRecordError
+ * @brief Why readCsvRecord could not return a whole record
+ */
+enum class CsvRecordError {
+    None,
+    Unterminated,   ///< A quoted field ran into end of input
+    TooLong         ///< Longer than MAX_CSV_RECORD; the rest of its line was skipped
+};
+
+// Drop input up to and including the next line break
+void skipLine(CharSource& src) {
+    int c;
+    while ((c = src.get()) != EOF && c != '\n') {
+    }
+}
+
+/**
+ * @brief Read one RFC 4180 record
+ * @param fields Reused field buffers; only the first count are valid
+ * @param count Output: number of fields
+ * @param error Output: why the record is incomplete, if it is
+ * @return False at end of input
+ */
+bool readCsvRecord(CharSource& src, std::vector<std::string>& fields, size_t& count,
+                   CsvRecordError& error) {
+    count = 0;
+    error = CsvRecordError::None;
+    if (src.peek() == EOF) {
+        return false;
+    }
+    size_t length = 0;
+    while (true) {
+        if (fields.size() <= count) {
+            fields.push_back(std::string());
+        }
+        std::string& field = fields[count++];
+        field.clear();
+
+        int c = src.peek();
+        if (c == '"') {
+            src.get();
+            while (true) {
+                c = src.get();
+                if (c == EOF) {
+                    error = CsvRecordError::Unterminated;
+                    return true;
+                }
+                if (c == '"') {
+                    if (src.peek() != '"') break;
+                    src.get();
+                }
+                if (++length > MAX_CSV_RECORD) {
+                    if (c != '\n') skipLine(src);
+                    error = CsvRecordError::TooLong;
+                    return true;
+                }
+                field.push_back(static_cast<char>(c));
+            }
+        }
+        // Unquoted field, or stray text after a closing quote (kept leniently)
+        while ((c = src.peek()) != EOF && c != ',' && c != '\n' && c != '\r') {
+            if (++length > MAX_CSV_RECORD) {
+                skipLine(src);
+                error = CsvRecordError::TooLong;
+                return true;
+            }
+            field.push_back(static_cast<char>(src.get()));
+        }
+
+        c = src.get();
+        if (c == ',') {
+            continue;
+        }
+        if (c == '\r' && src.peek() == '\n') {
+            src.get();
+        }
+        return true;
+    }
+}
+
+/**
+ * @class JsonSyntaxError
+ * @brief Malformed JSON; ends reading
+ */
+class JsonSyntaxError : public std::runtime_error {
+public:
+    size_t line;
+
+    JsonSyntaxError(size_t at, const std::string& message)
+        : std::runtime_error(message), line(at) {}
+};
+
+/**
+ * @class GeoJsonReader
+ * @brief Pull parser that decodes one feature at a time
+ *
+ * Only the parts of a feature the loader uses are kept (type, geometry
+ * positions, scalar properties); everything else is skipped while
+ * parsing. The scratch buffers are reused, so after the first few
+ * features parsing allocates little.
+ */
+class GeoJsonReader {
+private:
+    /**
+     * @struct Position
+     * @brief Longitude/latitude and the coordinate list (line, ring) it belongs to
+     */
+    struct Position {
+        double longitude;
+        double latitude;
+        size_t part;
+    };
+
+    CharSource& src_;
+    LoadReport& report_;
+    const CampusDataLoader::BuildingSink& onBuilding_;
+    const CampusDataLoader::PathSink& onPath_;
+
+    // Feature being decoded
+    size_t line_;
+    std::string type_;
+    std::string geometryType_;
+    bool hasGeometry_;
+    std::vector<Position> positions_;
+    size_t parts_;
+    std::vector<std::pair<std::string, std::string>> properties_;
+    size_t propertyCount_;
+
+    // Scratch
+    std::string key_;
+    std::string number_;
+    std::vector<double> values_;
+    BuildingInfo building_;
+    PathConnection path_;
+
+    JsonSyntaxError error(const std::string& message) const {
+        return JsonSyntaxError(src_.line(), message);
+    }
+
+    void skipWhitespace() {
+        int c;
+        while ((c = src_.peek()) == ' ' || c == '\t' || c == '\n' || c == '\r' || c == 0x1E) {
+            src_.get();
+        }
+    }
+
+    void expect(char wanted) {
+        skipWhitespace();
+        int c = src_.get();
+        if (c != wanted) {
+            throw error(std::string("expected '") + wanted + "'" +
+                        (c == EOF ? " before end of input" : ""));
+        }
+    }
+
+    // Consume ',' (true) or the closing bracket (false)
+    bool nextItem(char close) {
+        skipWhitespace();
+        int c = src_.get();
+        if (c == ',') return true;
+        if (c == close) return false;
+        throw error(std::string("expected ',' or '") + close + "'");
+    }
+
+    // Open an object/array; false if it is empty (closing bracket consumed)
+    bool open(char openChar, char close) {
+        expect(openChar);
+        skipWhitespace();
+        if (src_.peek() == close) {
+            src_.get();
+            return false;
+        }
+        return true;
+    }
+
+    void appendUtf8(std::string& out, unsigned long code) {
+        if (code < 0x80) {
+            out.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+
+    unsigned long readHex4() {
+        unsigned long code = 0;
+        for (int i = 0; i < 4; ++i) {
+            int c = src_.get();
+            if (!std::isxdigit(c)) {
+                throw error("invalid \\u escape");
+            }
+            code = code * 16 + static_cast<unsigned long>(std::isdigit(c) ? c - '0' : std::tolower(c) - 'a' + 10);
+        }
+        return code;
+    }
+
+    void parseString(std::string& out) {
+        out.clear();
+        expect('"');
+        while (true) {
+            int c = src_.get();
+            if (c == EOF) throw error("unterminated string");
+            if (c == '"') return;
+            if (c != '\\') {
+                out.push_back(static_cast<char>(c));
+                continue;
+            }
+            c = src_.get();
+            switch (c) {
+            case '"': case '\\': case '/': out.push_back(static_cast<char>(c)); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+            case 'u': {
+                unsigned long code = readHex4();
+                if (code >= 0xD800 && code < 0xDC00 && src_.peek() == '\\') {
+                    src_.get();
+                    if (src_.get() != 'u') throw error("invalid surrogate pair");
+                    unsigned long low = readHex4();
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUtf8(out, code);
+                break;
+            }
+            default:
+                throw error("invalid escape in string");
+            }
+        }
+    }
+
+    double parseNumber() {
+        skipWhitespace();
+        number_.clear();
+        int c;
+        while ((c = src_.peek()) != EOF &&
+               (std::isdigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) {
+            number_.push_back(static_cast<char>(src_.get()));
+        }
+        double value;
+        if (!parseDouble(number_, value)) {
+            throw error("invalid number '" + number_ + "'");
+        }
+        return value;
+    }
+
+    void parseLiteral(const char* word) {
+        for (const char* p = word; *p; ++p) {
+            if (src_.get() != *p) {
+                throw error(std::string("invalid literal, expected ") + word);
+            }
+        }
+    }
+
+    // Parse and discard any value
+    void skipValue(int depth) {
+        if (depth > MAX_JSON_DEPTH) throw error("nesting too deep");
+        skipWhitespace();
+        int c = src_.peek();
+        if (c == '{') {
+            if (!open('{', '}')) return;
+            do {
+                parseString(key_);
+                expect(':');
+                skipValue(depth + 1);
+            } while (nextItem('}'));
+        } else if (c == '[') {
+            if (!open('[', ']')) return;
+            do {
+                skipValue(depth + 1);
+            } while (nextItem(']'));
+        } else if (c == '"') {
+            parseString(number_);
+        } else if (c == 't') {
+            parseLiteral("true");
+        } else if (c == 'f') {
+            parseLiteral("false");
+        } else if (c == 'n') {
+            parseLiteral("null");
+        } else if (c == EOF) {
+            throw error("unexpected end of input");
+        } else {
+            parseNumber();
+        }
+    }
+
+    // Scalar properties are kept as text; nested values are skipped
+    void parseProperties(int depth) {
+        skipWhitespace();
+        if (src_.peek() == 'n') {
+            parseLiteral("null");
+            return;
+        }
+        if (!open('{', '}')) return;
+        do {
+            if (properties_.size() <= propertyCount_) {
+                properties_.push_back(std::make_pair(std::string(), std::string()));
+            }
+            std::pair<std::string, std::string>& property = properties_[propertyCount_];
+            parseString(property.first);
+            expect(':');
+            skipWhitespace();
+            int c = src_.peek();
+            if (c == '"') {
+                parseString(property.second);
+            } else if (c == '-' || std::isdigit(c)) {
+                parseNumber();
+                property.second = number_;
+            } else if (c == 't') {
+                parseLiteral("true");
+                property.second = "true";
+            } else if (c == 'f') {
+                parseLiteral("false");
+                property.second = "false";
+            } else if (c == 'n') {
+                parseLiteral("null");
+                property.second.clear();
+            } else {
+                skipValue(depth + 1);
+                continue;
+            }
+            ++propertyCount_;
+        } while (nextItem('}'));
+    }
+
+    void parseGeometry(int depth) {
+        skipWhitespace();
+        if (src_.peek() == 'n') {
+            parseLiteral("null");
+            return;
+        }
+        hasGeometry_ = true;
+        if (!open('{', '}')) return;
+        do {
+            parseString(key_);
+            expect(':');
+            if (key_ == "type") {
+                parseString(geometryType_);
+            } else if (key_ == "coordinates") {
+                parseCoordinateTree(depth + 1);
+            } else {
+                skipValue(depth + 1);
+            }
+        } while (nextItem('}'));
+    }
+
+    /**
+     * @brief Parse a coordinates member of any depth
+     *
+     * Depth 1 is a Point, depth 2 a LineString / ring, depth 3 a Polygon
+     * or MultiLineString. Each array of positions becomes its own part.
+     */
+    void parseCoordinateTree(int depth) {
+        if (depth > MAX_JSON_DEPTH) throw error("nesting too deep");
+        skipWhitespace();
+        if (!open('[', ']')) return;
+        skipWhitespace();
+        if (src_.peek() != '[') {
+            // A single position
+            values_.clear();
+            do {
+                values_.push_back(parseNumber());
+            } while (nextItem(']'));
+            if (values_.size() < 2) throw error("position needs longitude and latitude");
+            Position p = { values_[0], values_[1], parts_ };
+            positions_.push_back(p);
+            return;
+        }
+        // Peek one level further: "[[x, y], ...]" is a list of positions
+        bool first = true;
+        bool positionList = false;
+        do {
+            skipWhitespace();
+            if (first) {
+                src_.get();     // the '[' of the first element
+                skipWhitespace();
+                positionList = src_.peek() != '[';
+                if (positionList) {
+                    ++parts_;
+                }
+                finishElement(positionList, depth + 1);
+                first = false;
+            } else {
+                if (src_.peek() != '[') throw error("mixed coordinate nesting");
+                src_.get();
+                finishElement(positionList, depth + 1);
+            }
+        } while (nextItem(']'));
+    }
+
+    // Rest of an element whose '[' has been consumed
+    void finishElement(bool position, int depth) {
+        if (depth > MAX_JSON_DEPTH) throw error("nesting too deep");
+        skipWhitespace();
+        if (position) {
+            values_.clear();
+            if (src_.peek() == ']') throw error("position needs longitude and latitude");
+            do {
+                values_.push_back(parseNumber());
+            } while (nextItem(']'));
+            if (values_.size() < 2) throw error("position needs longitude and latitude");
+            Position p = { values_[0], values_[1], parts_ - 1 };
+            positions_.push_back(p);
+            return;
+        }
+        // A list of deeper arrays: recurse as if it were a fresh tree
+        if (src_.peek() == ']') {
+            src_.get();
+            return;
+        }
+        bool firstChild = true;
+        bool childPositions = false;
+        do {
+            skipWhitespace();
+            if (src_.peek() != '[') throw error("mixed coordinate nesting");
+            src_.get();
+            if (firstChild) {
+                skipWhitespace();
+                childPositions = src_.peek() != '[';
+                if (childPositions) {
+                    ++parts_;
+                }
+                firstChild = false;
+            }
+            finishElement(childPositions, depth + 1);
+        } while (nextItem(']'));
+    }
+
+    const std::string* property(const char* name) const {
+        for (size_t i = 0; i < propertyCount_; ++i) {
+            if (properties_[i].first == name) {
+                return &properties_[i].second;
+            }
+        }
+        return nullptr;
+    }
+
+    std::string propertyOr(const char* name, const char* fallback, const std::string& otherwise) const {
+        const std::string* value = property(name);
+        if (value == nullptr) value = property(fallback);
+        return value != nullptr ? *value : otherwise;
+    }
+
+    void resetFeature() {
+        line_ = src_.line();
+        type_.clear();
+        geometryType_.clear();
+        hasGeometry_ = false;
+        positions_.clear();
+        parts_ = 0;
+        propertyCount_ = 0;
+    }
+
+    // Members shared by a Feature and a top-level object
+    void parseFeatureMember(int depth) {
+        if (key_ == "type") {
+            parseString(type_);
+        } else if (key_ == "geometry") {
+            parseGeometry(depth + 1);
+        } else if (key_ == "properties") {
+            parseProperties(depth + 1);
+        } else {
+            skipValue(depth + 1);
+        }
+    }
+
+    void parseFeature() {
+        skipWhitespace();
+        resetFeature();
+        if (!open('{', '}')) {
+            addIssue(report_, line_, "empty feature");
+            return;
+        }
+        do {
+            parseString(key_);
+            expect(':');
+            parseFeatureMember(1);
+        } while (nextItem('}'));
+        emitFeature();
+    }
+
+    void emitFeature() {
+        if (type_ != "Feature") {
+            addIssue(report_, line_, "expected a Feature, got '" + type_ + "'");
+            return;
+        }
+        const std::string* from = property("from");
+        const std::string* to = property("to");
+        bool isLine = geometryType_ == "LineString" || geometryType_ == "MultiLineString";
+        if (isLine || (!hasGeometry_ && from != nullptr && to != nullptr)) {
+            emitPath(from, to);
+            return;
+        }
+        if (!hasGeometry_) {
+            addIssue(report_, line_, "feature has no geometry");
+            return;
+        }
+        if (geometryType_ != "Point" && geometryType_ != "Polygon") {
+            addIssue(report_, line_, "unsupported geometry type '" + geometryType_ + "'");
+            return;
+        }
+        if (positions_.empty()) {
+            addIssue(report_, line_, geometryType_ + " has no coordinates");
+            return;
+        }
+
+        // Point, or mean of the outer ring without its closing vertex
+        const size_t outer = positions_.front().part;
+        size_t count = 0;
+        while (count < positions_.size() && positions_[count].part == outer) {
+            ++count;
+        }
+        if (count > 1 && positions_[count - 1].latitude == positions_[0].latitude &&
+            positions_[count - 1].longitude == positions_[0].longitude) {
+            --count;
+        }
+        double lat = 0.0, lon = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            lat += positions_[i].latitude;
+            lon += positions_[i].longitude;
+        }
+        building_.name = propertyOr("name", "name", std::string());
+        building_.latitude = lat / count;
+        building_.longitude = lon / count;
+        building_.description = propertyOr("description", "desc", std::string());
+        building_.buildingType = propertyOr("type", "buildingType", std::string());
+        std::string problem = checkBuilding(building_);
+        if (!problem.empty()) {
+            addIssue(report_, line_, problem);
+            return;
+        }
+        ++report_.buildings;
+        onBuilding_(building_);
+    }
+
+    void emitPath(const std::string* from, const std::string* to) {
+        path_.from = from != nullptr ? *from : std::string();
+        path_.to = to != nullptr ? *to : std::string();
+        path_.distanceMeters = 0.0;
+        const std::string* distance = property("distance");
+        if (distance == nullptr) distance = property("distanceMeters");
+        if (distance != nullptr && !distance->empty()) {
+            if (!parseDouble(*distance, path_.distanceMeters)) {
+                addIssue(report_, line_, "invalid distance '" + *distance + "'");
+                return;
+            }
+        } else {
+            // Length along the drawn line
+            for (size_t i = 1; i < positions_.size(); ++i) {
+                const Position& a = positions_[i - 1];
+                const Position& b = positions_[i];
+                if (a.part != b.part) continue;
+                if (!(std::fabs(a.latitude) <= 90.0 && std::fabs(b.latitude) <= 90.0 &&
+                      std::fabs(a.longitude) <= 180.0 && std::fabs(b.longitude) <= 180.0)) {
+                    addIssue(report_, line_, "line coordinates out of range");
+                    return;
+                }
+                Location pa("", a.latitude, a.longitude, "", 0);
+                Location pb("", b.latitude, b.longitude, "", 0);
+                path_.distanceMeters += pa.distanceTo(pb);
+            }
+        }
+        std::string problem = checkPath(path_);
+        if (!problem.empty()) {
+            addIssue(report_, line_, problem);
+            return;
+        }
+        ++report_.paths;
+        onPath_(path_);
+    }
+
+    // FeatureCollection (features streamed) or a bare Feature
+    void parseTopObject() {
+        resetFeature();
+        std::string topType;
+        bool sawFeatures = false;
+        if (!open('{', '}')) return;
+        do {
+            parseString(key_);
+            expect(':');
+            if (key_ == "features") {
+                sawFeatures = true;
+                if (open('[', ']')) {
+                    do {
+                        parseFeature();
+                    } while (nextItem(']'));
+                }
+            } else if (key_ == "type") {
+                parseString(topType);
+                type_ = topType;
+            } else {
+                parseFeatureMember(1);
+            }
+        } while (nextItem('}'));
+
+        if (topType == "Feature" && !sawFeatures) {
+            type_ = topType;
+            emitFeature();
+        } else if (topType != "FeatureCollection") {
+            addIssue(report_, line_, "expected a Feature or FeatureCollection, got '" + topType + "'");
+        }
+    }
+
+public:
+    GeoJsonReader(CharSource& src, LoadReport& report,
+                  const CampusDataLoader::BuildingSink& onBuilding,
+                  const CampusDataLoader::PathSink& onPath)
+        : src_(src), report_(report), onBuilding_(onBuilding), onPath_(onPath),
+          line_(1), hasGeometry_(false), parts_(0), propertyCount_(0) {
+        building_.latitude = building_.longitude = 0.0;
+        path_.distanceMeters = 0.0;
+    }
+
+    void run() {
+        while (true) {
+            skipWhitespace();
+            int c = src_.peek();
+            if (c == EOF) {
+                return;
+            }
+            if (c == '{') {
+                parseTopObject();
+            } else if (c == '[') {
+                // Bare array of features
+                if (open('[', ']')) {
+                    do {
+                        parseFeature();
+                    } while (nextItem(']'));
+                }
+            } else {
+                throw error("expected a GeoJSON object");
+            }
+        }
+    }
+};
+
+} // namespace
+
+/**
+ * @brief CSV reader
+ *
+ * The header decides which columns are read; every later record is
+ * turned into a building or a path, or reported and skipped.
+ */
+LoadReport CampusDataLoader::readCsv(std::istream& in, const BuildingSink& onBuilding,
+                                     const PathSink& onPath) {
+    LoadReport report;
+    CharSource src(in);
+    std::vector<std::string> fields;
+    size_t count = 0;
+    CsvRecordError error = CsvRecordError::None;
+    bool haveHeader = false;
+    CsvColumns columns;
+    BuildingInfo building;
+    PathConnection path;
+
+    auto field = [&](int index) -> const std::string& {
+        static const std::string empty;
+        return (index >= 0 && static_cast<size_t>(index) < count) ? fields[index] : empty;
+    };
+
+    while (true) {
+        size_t line = src.line();
+        if (!readCsvRecord(src, fields, count, error)) {
+            break;
+        }
+        if (error == CsvRecordError::Unterminated) {
+            addIssue(report, line, "quoted field is not closed before end of file");
+            break;
+        }
+        if (error == CsvRecordError::TooLong) {
+            addIssue(report, line, "record longer than " + std::to_string(MAX_CSV_RECORD) +
+                     " bytes (unclosed quote?); skipped to line " + std::to_string(src.line()));
+            continue;
+        }
+        if ((count == 1 && fields[0].find_first_not_of(" \t") == std::string::npos) ||
+            (!fields[0].empty() && fields[0][0] == '#')) {
+            continue;   // blank line or comment
+        }
+
+        if (!haveHeader) {
+            for (size_t i = 0; i < count; ++i) {
+                columns.assign(fields[i], static_cast<int>(i));
+            }
+            haveHeader = true;
+            if (columns.kind < 0 && columns.hasBuildings() == columns.hasPaths()) {
+                addIssue(report, line, columns.hasBuildings()
+                    ? "header has both building and path columns; add a kind column"
+                    : "header needs name, latitude, longitude or from, to columns");
+                report.complete = false;
+                break;
+            }
+            continue;
+        }
+
+        bool isPath = columns.hasPaths() && !columns.hasBuildings();
+        if (columns.kind >= 0) {
+            std::string kind = normalizeKey(field(columns.kind));
+            if (kind == "path" || kind == "edge" || kind == "connection") {
+                isPath = true;
+            } else if (kind == "building" || kind == "node" || kind == "location") {
+                isPath = false;
+            } else {
+                addIssue(report, line, "unknown kind '" + field(columns.kind) + "'");
+                continue;
+            }
+        }
+
+        std::string problem;
+        if (isPath) {
+            path.from = field(columns.from);
+            path.to = field(columns.to);
+            path.distanceMeters = 0.0;
+            const std::string& distance = field(columns.distance);
+            if (distance.find_first_not_of(" \t") != std::string::npos &&
+                !parseDouble(distance, path.distanceMeters)) {
+                problem = "invalid distance '" + distance + "'";
+            }
+            if (problem.empty()) problem = checkPath(path);
+            if (problem.empty()) {
+                ++report.paths;
+                onPath(path);
+            }
+        } else {
+            building.name = field(columns.name);
+            building.description = field(columns.description);
+            building.buildingType = field(columns.type);
+            if (!parseDouble(field(columns.latitude), building.latitude)) {
+                problem = "invalid latitude '" + field(columns.latitude) + "'";
+            } else if (!parseDouble(field(columns.longitude), building.longitude)) {
+                problem = "invalid longitude '" + field(columns.longitude) + "'";
+            }
+            if (problem.empty()) problem = checkBuilding(building);
+            if (problem.empty()) {
+                ++report.buildings;
+                onBuilding(building);
+            }
+        }
+        if (!problem.empty()) {
+            addIssue(report, line, problem);
+        }
+    }
+    report.lines = src.linesRead();
+    return report;
+}
+
+// GeoJSON reader; a syntax error ends the input
+LoadReport CampusDataLoader::readGeoJson(std::istream& in, const BuildingSink& onBuilding,
+                                         const PathSink& onPath) {
+    LoadReport report;
+    CharSource src(in);
+    GeoJsonReader reader(src, report, onBuilding, onPath);
+    try {
+        reader.run();
+    } catch (const JsonSyntaxError& e) {
+        addIssue(report, e.line, std::string("JSON syntax error: ") + e.what());
+        report.complete = false;
+    }
+    report.lines = src.linesRead();
+    return report;
+}
+
+// Open a file and pick the reader
+LoadReport CampusDataLoader::loadFile(const std::string& path, const BuildingSink& onBuilding,
+                                      const PathSink& onPath, Format format) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) {
+        throw CampusDataException("Cannot open campus data file: " + path);
+    }
+    if (format == Format::Auto) {
+        std::string extension;
+        size_t dot = path.find_last_of('.');
+        if (dot != std::string::npos && path.find_first_of("/\\", dot) == std::string::npos) {
+            extension = normalizeKey(path.substr(dot + 1));
+        }
+        if (extension == "csv") {
+            format = Format::Csv;
+        } else if (extension == "geojson" || extension == "json" || extension == "geojsonl" ||
+                   extension == "geojsons" || extension == "ndjson" || extension == "jsonl") {
+            format = Format::GeoJson;
+        } else {
+            // Sniff the first significant character
+            int c;
+            while ((c = in.peek()) != EOF && (std::isspace(c) || c == 0xEF || c == 0xBB || c == 0xBF)) {
+                in.get();
+            }
+            format = (c == '{' || c == '[' || c == 0x1E) ? Format::GeoJson : Format::Csv;
+            in.clear();
+            in.seekg(0);
+        }
+    }
+    LoadReport report = (format == Format::GeoJson) ? readGeoJson(in, onBuilding, onPath)
+                                                    : readCsv(in, onBuilding, onPath);
+    if (in.bad()) {
+        throw CampusDataException("Read error in campus data file: " + path);
+    }
+    return report;
+}
+
+// Collect a file into vectors
+LoadReport CampusDataLoader::loadFile(const std::string& path,
+                                      std::vector<CampusData::BuildingInfo>& buildings,
+                                      std::vector<CampusData::PathConnection>& paths,
+                                      Format format) {
+    return loadFile(path,
+                    [&buildings](const BuildingInfo& b) { buildings.push_back(b); },
+                    [&paths](const PathConnection& p) { paths.push_back(p); },
+                    format);
+}
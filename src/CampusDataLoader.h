@@ -0,0 +1,157 @@
+/**
+ * @file CampusDataLoader.h
+ * @brief Streaming CSV / GeoJSON reader for campus buildings and paths.
+ *
+ * Fills the same BuildingInfo / PathConnection records as CampusData.h,
+ * so map data can be edited without recompiling. Input is read through a
+ * fixed-size buffer and handed to callbacks one record at a time: memory
+ * use does not grow with the file unless the caller keeps the records.
+ *
+ * CSV: the first row names the columns (any order, case-insensitive,
+ * unknown columns ignored). A file with name/latitude/longitude columns
+ * holds buildings (optional description, type); one with from/to columns
+ * holds paths (optional distance, 0 = straight-line distance). A "kind"
+ * column with the values building/path allows both in one file. Fields
+ * follow RFC 4180 quoting, so quoted fields may contain commas, doubled
+ * quotes and line breaks. A record is limited to 64 KiB: a longer one
+ * (usually a quote that is never closed) is reported at its first line and
+ * reading resumes at the next line break. Empty lines and lines starting
+ * with '#' are skipped.
+ *
+ * GeoJSON: a FeatureCollection (streamed feature by feature), a single
+ * Feature, or a sequence of Features (newline-delimited or RFC 8142).
+ * Point features are buildings, Polygon features buildings at the mean of
+ * their vertices. Properties: name, description, type (or buildingType).
+ * LineString features with from/to properties are paths; without a
+ * distance property their length is measured along the line.
+ *
+ * Bad records are skipped and reported with their line number; loading
+ * goes on. A JSON syntax error ends the file, since the reader cannot
+ * resynchronise reliably.
+ */
+
+#ifndef CAMPUS_DATA_LOADER_H
+#define CAMPUS_DATA_LOADER_H
+
+#include "CampusData.h"
+#include <string>
+#include <vector>
+#include <istream>
+#include <functional>
+#include <stdexcept>
+#include <cstddef>
+
+/**
+ * @class CampusDataException
+ * @brief Thrown when an input file cannot be opened or read
+ */
+class CampusDataException : public std::runtime_error {
+public:
+    explicit CampusDataException(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+/**
+ * @struct LoadIssue
+ * @brief One rejected record
+ */
+struct LoadIssue {
+    size_t line;            ///< 1-based line where the record starts
+    std::string message;    ///< What was wrong
+};
+
+/**
+ * @struct LoadReport
+ * @brief Outcome of loading one input
+ */
+struct LoadReport {
+    size_t buildings;               ///< Buildings delivered
+    size_t paths;                   ///< Paths delivered
+    size_t lines;                   ///< Lines read
+    size_t errorCount;              ///< Records rejected (may exceed errors.size())
+    bool complete;                  ///< False if a syntax error stopped reading early
+    std::vector<LoadIssue> errors;  ///< First MAX_REPORTED_ERRORS problems
+
+    LoadReport() : buildings(0), paths(0), lines(0), errorCount(0), complete(true) {}
+};
+
+/**
+ * @class CampusDataLoader
+ * @brief Reads buildings and paths from CSV or GeoJSON
+ *
+ * Example usage:
+ * @code
+ * std::vector<CampusData::BuildingInfo> buildings;
+ * std::vector<CampusData::PathConnection> paths;
+ * LoadReport report = CampusDataLoader::loadFile("campus.geojson", buildings, paths);
+ * for (const LoadIssue& issue : report.errors) {
+ *     std::cerr << "line " << issue.line << ": " << issue.message << "\n";
+ * }
+ * @endcode
+ */
+class CampusDataLoader {
+public:
+    typedef std::function<void(const CampusData::BuildingInfo&)> BuildingSink;
+    typedef std::function<void(const CampusData::PathConnection&)> PathSink;
+
+    /**
+     * @enum Format
+     * @brief Input format
+     */
+    enum class Format {
+        Auto,       ///< From the file extension, else from the first character
+        Csv,
+        GeoJson
+    };
+
+    /// Problems kept in LoadReport::errors; later ones are only counted
+    static const size_t MAX_REPORTED_ERRORS = 100;
+
+    /**
+     * @brief Stream CSV records to callbacks
+     * @param in Input stream (opened in binary mode for files)
+     * @param onBuilding Called for every valid building
+     * @param onPath Called for every valid path
+     * @return Counts and rejected records
+     */
+    static LoadReport readCsv(std::istream& in, const BuildingSink& onBuilding,
+                              const PathSink& onPath);
+
+    /**
+     * @brief Stream GeoJSON features to callbacks
+     * @param in Input stream
+     * @param onBuilding Called for every valid building
+     * @param onPath Called for every valid path
+     * @return Counts and rejected records
+     */
+    static LoadReport readGeoJson(std::istream& in, const BuildingSink& onBuilding,
+                                  const PathSink& onPath);
+
+    /**
+     * @brief Stream a file to callbacks
+     * @param path Input file
+     * @param onBuilding Called for every valid building
+     * @param onPath Called for every valid path
+     * @param format Input format
+     * @return Counts and rejected records
+     * @throws CampusDataException if the file cannot be opened
+     */
+    static LoadReport loadFile(const std::string& path, const BuildingSink& onBuilding,
+                               const PathSink& onPath, Format format = Format::Auto);
+
+    /**
+     * @brief Append the contents of a file to vectors
+     * @param path Input file
+     * @param buildings Output: buildings are appended
+     * @param paths Output: paths are appended
+     * @param format Input format
+     * @return Counts and rejected records
+     * @throws CampusDataException if the file cannot be opened
+     */
+    static LoadReport loadFile(const std::string& path,
+                               std::vector<CampusData::BuildingInfo>& buildings,
+                               std::vector<CampusData::PathConnection>& paths,
+                               Format format = Format::Auto);
+};
+
+#endif // CAMPUS_DATA_LOADER_H
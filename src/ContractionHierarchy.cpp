@@ -0,0 +1,351 @@
+/**
+ * @file ContractionHierarchy.cpp
+ * @brief Node ordering, contraction, query and unpacking for CH.
+ */
+
+#include "ContractionHierarchy.h"
+#include <queue>
+#include <limits>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+namespace {
+
+const double INF = std::numeric_limits<double>::infinity();
+const uint32_t NONE = 0xFFFFFFFFu;
+
+// Witness searches give up after settling this many nodes; a missed
+// witness only costs a superfluous shortcut, never a wrong answer.
+const size_t WITNESS_SETTLE_LIMIT = 128;
+
+/**
+ * @struct DynArc
+ * @brief Arc in the shrinking graph used during contraction
+ */
+struct DynArc {
+    uint32_t node;
+    double weight;
+    uint32_t middle;
+};
+
+/**
+ * @struct FullArc
+ * @brief Arc kept for the final hierarchy (original or shortcut)
+ */
+struct FullArc {
+    uint32_t from;
+    uint32_t to;
+    double weight;
+    uint32_t middle;
+};
+
+/**
+ * @brief Insert an arc or lower the weight of an existing one
+ */
+void addOrImprove(std::vector<DynArc>& arcs, uint32_t node, double weight, uint32_t middle) {
+    for (DynArc& arc : arcs) {
+        if (arc.node == node) {
+            if (weight < arc.weight) {
+                arc.weight = weight;
+                arc.middle = middle;
+            }
+            return;
+        }
+    }
+    DynArc arc = { node, weight, middle };
+    arcs.push_back(arc);
+}
+
+/**
+ * @brief Remove the arc pointing at node, if any
+ */
+void removeArc(std::vector<DynArc>& arcs, uint32_t node) {
+    arcs.erase(std::remove_if(arcs.begin(), arcs.end(),
+                              [node](const DynArc& a) { return a.node == node; }),
+               arcs.end());
+}
+
+/**
+ * @brief Flatten per-node arc lists into offsets + arcs
+ */
+void flatten(const std::vector<std::vector<ContractionHierarchy::Arc>>& lists,
+             std::vector<uint32_t>& offsets, std::vector<ContractionHierarchy::Arc>& arcs) {
+    offsets.assign(1, 0);
+    arcs.clear();
+    for (const auto& list : lists) {
+        arcs.insert(arcs.end(), list.begin(), list.end());
+        offsets.push_back(static_cast<uint32_t>(arcs.size()));
+    }
+}
+
+} // namespace
+
+// Constructor
+ContractionHierarchy::ContractionHierarchy()
+    : nodeCount_(0), upOffsets_(1, 0), downOffsets_(1, 0),
+      shortcutCount_(0), buildMillis_(0.0) {
+}
+
+// Contract all nodes
+void ContractionHierarchy::contract(size_t nodeCount, const std::vector<Triple>& edges) {
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    nodeCount_ = nodeCount;
+    shortcutCount_ = 0;
+
+    std::vector<std::vector<DynArc>> out(nodeCount), in(nodeCount);
+    std::vector<FullArc> all;
+    all.reserve(edges.size() * 2);
+    for (const Triple& e : edges) {
+        if (e.from == e.to) {
+            continue;
+        }
+        addOrImprove(out[e.from], e.to, e.weight, NONE);
+        addOrImprove(in[e.to], e.from, e.weight, NONE);
+        FullArc arc = { e.from, e.to, e.weight, NONE };
+        all.push_back(arc);
+    }
+
+    std::vector<char> contracted(nodeCount, 0);
+    std::vector<uint32_t> deletedNeighbors(nodeCount, 0);
+    SearchWorkspace witness;
+
+    // Local Dijkstra from u that avoids v, bounded by maxDist
+    auto witnessSearch = [&](uint32_t u, uint32_t v, double maxDist) {
+        witness.begin(nodeCount);
+        witness.setDistance(u, 0.0, NONE);
+        witness.push(0.0, u);
+        size_t settled = 0;
+        while (!witness.empty()) {
+            SearchWorkspace::QueueEntry top = witness.pop();
+            if (witness.isSettled(top.second)) continue;
+            if (top.first > maxDist || ++settled > WITNESS_SETTLE_LIMIT) break;
+            witness.settle(top.second);
+            for (const DynArc& arc : out[top.second]) {
+                if (arc.node == v || contracted[arc.node]) continue;
+                if (witness.relax(arc.node, top.first + arc.weight, top.second)) {
+                    witness.push(top.first + arc.weight, arc.node);
+                }
+            }
+        }
+    };
+
+    // Shortcuts required to contract v; recorded if requested
+    auto shortcutsFor = [&](uint32_t v, std::vector<FullArc>* record) {
+        int count = 0;
+        for (const DynArc& inArc : in[v]) {
+            uint32_t u = inArc.node;
+            double maxOut = -1.0;
+            for (const DynArc& outArc : out[v]) {
+                if (outArc.node != u) maxOut = std::max(maxOut, outArc.weight);
+            }
+            if (maxOut < 0.0) continue;     // no out-neighbour other than u
+            witnessSearch(u, v, inArc.weight + maxOut);
+            for (const DynArc& outArc : out[v]) {
+                uint32_t w = outArc.node;
+                if (w == u) continue;
+                double via = inArc.weight + outArc.weight;
+                if (witness.distance(w) > via) {
+                    ++count;
+                    if (record) {
+                        FullArc shortcut = { u, w, via, v };
+                        record->push_back(shortcut);
+                    }
+                }
+            }
+        }
+        return count;
+    };
+
+    // Edge difference + deleted neighbours keeps the hierarchy shallow and uniform
+    auto priority = [&](uint32_t v) {
+        return shortcutsFor(v, nullptr) - static_cast<int>(in[v].size() + out[v].size())
+               + static_cast<int>(deletedNeighbors[v]);
+    };
+
+    typedef std::pair<int, uint32_t> Candidate;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> order;
+    for (uint32_t v = 0; v < nodeCount; ++v) {
+        order.push(Candidate(priority(v), v));
+    }
+
+    rank_.assign(nodeCount, 0);
+    uint32_t nextRank = 0;
+    std::vector<FullArc> shortcuts;
+    while (!order.empty()) {
+        uint32_t v = order.top().second;
+        order.pop();
+        if (contracted[v]) continue;
+
+        // Lazy update: re-evaluate and defer if no longer the minimum
+        int current = priority(v);
+        if (!order.empty() && current > order.top().first) {
+            order.push(Candidate(current, v));
+            continue;
+        }
+
+        shortcuts.clear();
+        shortcutsFor(v, &shortcuts);
+        for (const FullArc& s : shortcuts) {
+            addOrImprove(out[s.from], s.to, s.weight, s.middle);
+            addOrImprove(in[s.to], s.from, s.weight, s.middle);
+            all.push_back(s);
+        }
+        shortcutCount_ += shortcuts.size();
+
+        for (const DynArc& arc : in[v]) {
+            removeArc(out[arc.node], v);
+            ++deletedNeighbors[arc.node];
+        }
+        for (const DynArc& arc : out[v]) {
+            removeArc(in[arc.node], v);
+            ++deletedNeighbors[arc.node];
+        }
+        in[v].clear();
+        out[v].clear();
+        contracted[v] = 1;
+        rank_[v] = nextRank++;
+    }
+
+    // Split every arc into the upward graph of its lower-ranked endpoint
+    std::vector<std::vector<Arc>> up(nodeCount), down(nodeCount);
+    for (const FullArc& a : all) {
+        if (rank_[a.from] < rank_[a.to]) {
+            Arc arc = { a.to, a.weight, a.middle };
+            up[a.from].push_back(arc);
+        } else {
+            Arc arc = { a.from, a.weight, a.middle };
+            down[a.to].push_back(arc);
+        }
+    }
+    flatten(up, upOffsets_, upArcs_);
+    flatten(down, downOffsets_, downArcs_);
+
+    buildMillis_ = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - started).count();
+}
+
+// Whether build() has been run
+bool ContractionHierarchy::empty() const {
+    return nodeCount_ == 0;
+}
+
+// Cheapest arc from -> to
+const ContractionHierarchy::Arc* ContractionHierarchy::findArc(uint32_t from, uint32_t to) const {
+    const Arc* best = nullptr;
+    if (rank_[from] < rank_[to]) {
+        for (uint32_t k = upOffsets_[from]; k < upOffsets_[from + 1]; ++k) {
+            if (upArcs_[k].target == to && (!best || upArcs_[k].weight < best->weight)) {
+                best = &upArcs_[k];
+            }
+        }
+    } else {
+        for (uint32_t k = downOffsets_[to]; k < downOffsets_[to + 1]; ++k) {
+            if (downArcs_[k].target == from && (!best || downArcs_[k].weight < best->weight)) {
+                best = &downArcs_[k];
+            }
+        }
+    }
+    return best;
+}
+
+// Unpack a (possibly nested) shortcut into original nodes
+void ContractionHierarchy::unpack(uint32_t from, uint32_t to, std::vector<uint32_t>& out) const {
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    stack.push_back(std::make_pair(from, to));
+    while (!stack.empty()) {
+        std::pair<uint32_t, uint32_t> arc = stack.back();
+        stack.pop_back();
+        const Arc* found = findArc(arc.first, arc.second);
+        if (found == nullptr || found->middle == NONE) {
+            out.push_back(arc.second);
+        } else {
+            // Process first half before second half
+            stack.push_back(std::make_pair(found->middle, arc.second));
+            stack.push_back(std::make_pair(arc.first, found->middle));
+        }
+    }
+}
+
+// Upward bidirectional query
+double ContractionHierarchy::query(uint32_t source, uint32_t target, std::vector<uint32_t>& nodes,
+                                   SearchWorkspace& forward, SearchWorkspace& backward,
+                                   SearchStats& stats) const {
+    nodes.clear();
+    forward.begin(nodeCount_);
+    backward.begin(nodeCount_);
+    forward.setDistance(source, 0.0, NONE);
+    forward.push(0.0, source);
+    backward.setDistance(target, 0.0, NONE);
+    backward.push(0.0, target);
+
+    double best = INF;
+    uint32_t meet = NONE;
+
+    while (true) {
+        bool forwardLive = !forward.empty() && forward.top().first < best;
+        bool backwardLive = !backward.empty() && backward.top().first < best;
+        if (!forwardLive && !backwardLive) {
+            break;
+        }
+        bool isForward = forwardLive &&
+                         (!backwardLive || forward.top().first <= backward.top().first);
+        SearchWorkspace& self = isForward ? forward : backward;
+        SearchWorkspace& other = isForward ? backward : forward;
+        const std::vector<uint32_t>& offsets = isForward ? upOffsets_ : downOffsets_;
+        const std::vector<Arc>& arcs = isForward ? upArcs_ : downArcs_;
+
+        SearchWorkspace::QueueEntry top = self.pop();
+        uint32_t u = top.second;
+        if (self.isSettled(u)) continue;
+        self.settle(u);
+
+        if (other.reached(u) && top.first + other.distance(u) < best) {
+            best = top.first + other.distance(u);
+            meet = u;
+        }
+
+        for (uint32_t k = offsets[u]; k < offsets[u + 1]; ++k) {
+            double tentative = top.first + arcs[k].weight;
+            if (self.relax(arcs[k].target, tentative, u)) {
+                self.push(tentative, arcs[k].target);
+            }
+        }
+    }
+
+    stats = forward.getStats();
+    stats.nodesSettled += backward.getStats().nodesSettled;
+    stats.edgesRelaxed += backward.getStats().edgesRelaxed;
+    stats.allocations += backward.getStats().allocations;
+
+    if (meet == NONE) {
+        return INF;
+    }
+
+    // Upward chain source -> meet, then downward chain meet -> target
+    std::vector<uint32_t> chain;
+    for (uint32_t v = meet; v != NONE; v = forward.previous(v)) {
+        chain.push_back(v);
+    }
+    std::reverse(chain.begin(), chain.end());
+    for (uint32_t v = backward.previous(meet); v != NONE; v = backward.previous(v)) {
+        chain.push_back(v);
+    }
+
+    nodes.push_back(chain.front());
+    for (size_t i = 1; i < chain.size(); ++i) {
+        unpack(chain[i - 1], chain[i], nodes);
+    }
+    return best;
+}
+
+// Number of shortcuts
+size_t ContractionHierarchy::getShortcutCount() const {
+    return shortcutCount_;
+}
+
+// Preprocessing time
+double ContractionHierarchy::getBuildMillis() const {
+    return buildMillis_;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file ContractionHierarchy.h
+ * @brief Contraction Hierarchies (CH) preprocessing and query engine.
+ *
+ * Nodes are contracted one by one in order of importance; whenever removing
+ * a node v would lengthen a shortest path u -> v -> w, a shortcut u -> w is
+ * added. Queries then run a bidirectional Dijkstra that only ever moves to
+ * higher-ranked nodes, which settles a tiny fraction of the graph. Every
+ * shortcut remembers the node it bypasses so results can be unpacked back
+ * into the original edges.
+ */
+
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include "CSRGraph.h"
+#include "SearchWorkspace.h"
+#include <vector>
+#include <limits>
+#include <cstdint>
+
+/**
+ * @class ContractionHierarchy
+ * @brief Index-based CH over a frozen CSRGraph
+ *
+ * Example usage:
+ * @code
+ * ContractionHierarchy ch;
+ * ch.build(csr);
+ * std::vector<uint32_t> nodes;
+ * double d = ch.query(s, t, nodes, fwd, bwd, stats);
+ * @endcode
+ */
+class ContractionHierarchy {
+public:
+    /**
+     * @struct Arc
+     * @brief Original edge or shortcut in the hierarchy
+     */
+    struct Arc {
+        uint32_t target;    ///< Other endpoint (dense index)
+        double weight;      ///< Arc length
+        uint32_t middle;    ///< Bypassed node for shortcuts, NO_NODE for original edges
+    };
+
+    /**
+     * @struct Triple
+     * @brief Directed input edge (from, to, weight)
+     */
+    struct Triple {
+        uint32_t from;
+        uint32_t to;
+        double weight;
+    };
+
+private:
+    size_t nodeCount_;                  ///< Number of nodes
+    std::vector<uint32_t> rank_;        ///< Contraction order position per node
+    std::vector<uint32_t> upOffsets_;   ///< Forward upward arcs of node i
+    std::vector<Arc> upArcs_;           ///< Arcs u -> w with rank[w] > rank[u]
+    std::vector<uint32_t> downOffsets_; ///< Backward upward arcs of node i
+    std::vector<Arc> downArcs_;         ///< Arcs w -> u stored at u with rank[w] > rank[u]
+    size_t shortcutCount_;              ///< Shortcuts added during contraction
+    double buildMillis_;                ///< Preprocessing time
+
+    /**
+     * @brief Contract all nodes and build the upward/downward arc arrays
+     */
+    void contract(size_t nodeCount, const std::vector<Triple>& edges);
+
+    /**
+     * @brief Find the cheapest arc from -> to among up and down arcs
+     */
+    const Arc* findArc(uint32_t from, uint32_t to) const;
+
+    /**
+     * @brief Append the unpacked original nodes of arc from -> to (excluding from)
+     */
+    void unpack(uint32_t from, uint32_t to, std::vector<uint32_t>& out) const;
+
+public:
+    /**
+     * @brief Constructor (empty hierarchy)
+     */
+    ContractionHierarchy();
+
+    /**
+     * @brief Preprocess a frozen graph
+     * @param graph CSR graph; node indices are shared with the hierarchy
+     */
+    template<typename T>
+    void build(const CSRGraph<T>& graph) {
+        std::vector<Triple> edges;
+        edges.reserve(graph.getEdgeCount());
+        for (uint32_t u = 0; u < graph.getNodeCount(); ++u) {
+            for (const CSREdge& e : graph.neighbors(u)) {
+                if (e.weight == std::numeric_limits<double>::infinity()) {
+                    continue;   // closed edge
+                }
+                Triple t = { u, e.target, e.weight };
+                edges.push_back(t);
+            }
+        }
+        contract(graph.getNodeCount(), edges);
+    }
+
+    /**
+     * @brief Whether build() has been run
+     */
+    bool empty() const;
+
+    /**
+     * @brief Shortest path query
+     * @param source Dense start index
+     * @param target Dense end index
+     * @param nodes Output: unpacked node sequence from source to target
+     * @param forward Workspace for the upward search from source
+     * @param backward Workspace for the upward search from target
+     * @param stats Output: combined search counters
+     * @return Distance, or infinity if target is unreachable
+     */
+    double query(uint32_t source, uint32_t target, std::vector<uint32_t>& nodes,
+                 SearchWorkspace& forward, SearchWorkspace& backward,
+                 SearchStats& stats) const;
+
+    /**
+     * @brief Number of shortcuts added by preprocessing
+     */
+    size_t getShortcutCount() const;
+
+    /**
+     * @brief Preprocessing time in milliseconds
+     */
+    double getBuildMillis() const;
+};
+
+#endif // CONTRACTION_HIERARCHY_H
@@ -0,0 +1,289 @@
+/**
+ * @file DeltaStepping.cpp
+ * @brief Implementation of parallel Delta-stepping.
+ */
+
+#include "DeltaStepping.h"
+#include <limits>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+namespace {
+
+const double INF = std::numeric_limits<double>::infinity();
+const uint32_t NONE = 0xFFFFFFFFu;
+
+// Caps the circular bucket array when Delta is tiny next to the longest edge
+const size_t MAX_BUCKETS = static_cast<size_t>(1) << 20;
+
+// Edge weights sampled for the median in autoDelta()
+const size_t DELTA_SAMPLES = 4096;
+
+// Non-negative doubles order like their bit patterns, so the atomic
+// minimum can compare integers
+uint64_t toBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double fromBits(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+// Constructor
+DeltaStepping::DeltaStepping(const CSRGraph<Location*>& graph, ThreadPool* pool)
+    : graph_(graph), pool_(pool), nodeCount_(0), pending_(0), delta_(0.0), relaxations_(0),
+      source_(NONE) {}
+
+// Median weight vs maxWeight / average degree
+double DeltaStepping::autoDelta(const CSRGraph<Location*>& graph) {
+    const size_t edgeCount = graph.getEdgeCount();
+    std::vector<double> sample;
+    double maxWeight = 0.0;
+    const size_t stride = std::max<size_t>(1, edgeCount / DELTA_SAMPLES);
+    for (uint32_t u = 0; u < graph.getNodeCount(); ++u) {
+        uint32_t id = graph.edgeBegin(u);
+        for (const CSREdge& edge : graph.neighbors(u)) {
+            if (edge.weight != INF) {
+                maxWeight = std::max(maxWeight, edge.weight);
+                if (id % stride == 0) {
+                    sample.push_back(edge.weight);
+                }
+            }
+            ++id;
+        }
+    }
+    if (sample.empty() || maxWeight <= 0.0) {
+        return 1.0;
+    }
+    std::nth_element(sample.begin(), sample.begin() + sample.size() / 2, sample.end());
+    double median = sample[sample.size() / 2];
+    double averageDegree = static_cast<double>(edgeCount) / graph.getNodeCount();
+    double delta = std::max(median, maxWeight / std::max(1.0, averageDegree));
+    return delta > 0.0 ? delta : maxWeight;
+}
+
+// Atomic minimum on the bit pattern
+bool DeltaStepping::relaxMin(uint32_t node, double dist) {
+    uint64_t candidate = toBits(dist);
+    uint64_t current = distance_[node].load(std::memory_order_relaxed);
+    while (candidate < current) {
+        if (distance_[node].compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// floor(distance / delta)
+uint64_t DeltaStepping::bucketOf(uint32_t node) const {
+    return static_cast<uint64_t>(distance(node) / delta_);
+}
+
+/**
+ * @brief One parallel relaxation step
+ *
+ * Chunks of nodes are relaxed on the pool; each chunk records the targets
+ * it improved in its own list. The lists are then merged on the calling
+ * thread, queueing every improved node in the bucket of its final
+ * distance. A node already queued there is not queued twice; an entry in
+ * an older bucket becomes stale and is skipped when that bucket is read.
+ */
+void DeltaStepping::relaxEdges(const std::vector<uint32_t>& nodes, bool light) {
+    const size_t count = nodes.size();
+    if (count == 0) {
+        return;
+    }
+    const bool parallel = pool_ != nullptr && pool_->size() > 1 && count >= SERIAL_FRONTIER;
+    const size_t grain = parallel
+        ? std::max<size_t>(SERIAL_FRONTIER / 4, count / (pool_->size() * 4)) : count;
+    const size_t chunks = (count + grain - 1) / grain;
+    if (updates_.size() < chunks) {
+        updates_.resize(chunks);
+    }
+    for (size_t c = 0; c < chunks; ++c) {
+        updates_[c].clear();
+    }
+
+    const double delta = delta_;
+    auto body = [&](size_t begin, size_t end) {
+        std::vector<uint32_t>& improved = updates_[begin / grain];
+        size_t relaxed = 0;
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t u = nodes[i];
+            double base = distance(u);
+            for (const CSREdge& edge : graph_.neighbors(u)) {
+                if ((edge.weight <= delta) != light || edge.weight == INF) {
+                    continue;
+                }
+                ++relaxed;
+                if (relaxMin(edge.target, base + edge.weight)) {
+                    improved.push_back(edge.target);
+                }
+            }
+        }
+        relaxations_ += relaxed;
+    };
+    if (parallel) {
+        pool_->parallelFor(count, body, grain);
+    } else {
+        body(0, count);
+    }
+
+    const size_t bucketCount = buckets_.size();
+    for (size_t c = 0; c < chunks; ++c) {
+        for (uint32_t v : updates_[c]) {
+            uint64_t bucket = bucketOf(v);
+            if (queuedIn_[v] != bucket + 1) {
+                queuedIn_[v] = bucket + 1;
+                buckets_[bucket % bucketCount].push_back(v);
+                ++pending_;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Delta-stepping main loop
+ *
+ * Tentative distances inserted while bucket i is processed lie below
+ * (i + 1) * Delta + maxWeight, so a circular array of
+ * ceil(maxWeight / Delta) + 2 buckets never wraps onto a live bucket.
+ */
+void DeltaStepping::run(uint32_t source, double delta) {
+    const size_t n = graph_.getNodeCount();
+    stats_ = Stats();
+    relaxations_ = 0;
+    source_ = source;
+
+    double maxWeight = 0.0;
+    for (uint32_t u = 0; u < n; ++u) {
+        for (const CSREdge& edge : graph_.neighbors(u)) {
+            if (edge.weight != INF) {
+                maxWeight = std::max(maxWeight, edge.weight);
+            }
+        }
+    }
+    delta_ = (delta > 0.0) ? delta : autoDelta(graph_);
+    if (maxWeight / delta_ > static_cast<double>(MAX_BUCKETS - 2)) {
+        delta_ = maxWeight / (MAX_BUCKETS - 2);
+    }
+    stats_.delta = delta_;
+
+    if (nodeCount_ != n) {
+        distance_.reset(new std::atomic<uint64_t>[n]);
+        nodeCount_ = n;
+    }
+    const uint64_t infinity = toBits(INF);
+    for (size_t v = 0; v < n; ++v) {
+        distance_[v].store(infinity, std::memory_order_relaxed);
+    }
+    queuedIn_.assign(n, 0);
+    const size_t bucketCount = static_cast<size_t>(std::ceil(maxWeight / delta_)) + 2;
+    buckets_.resize(bucketCount);
+    for (std::vector<uint32_t>& bucket : buckets_) {
+        bucket.clear();
+    }
+    pending_ = 0;
+    if (source >= n) {
+        return;
+    }
+
+    distance_[source].store(toBits(0.0), std::memory_order_relaxed);
+    queuedIn_[source] = 1;
+    buckets_[0].push_back(source);
+    pending_ = 1;
+
+    std::vector<uint32_t> frontier;
+    std::vector<uint32_t> removed;      // every node the bucket held, for the heavy pass
+    for (uint64_t current = 0; pending_ > 0; ++current) {
+        std::vector<uint32_t>& bucket = buckets_[current % bucketCount];
+        if (bucket.empty()) {
+            continue;
+        }
+        removed.clear();
+        while (!bucket.empty()) {
+            frontier.clear();
+            for (uint32_t v : bucket) {
+                --pending_;
+                if (queuedIn_[v] == current + 1) {
+                    queuedIn_[v] = 0;
+                    frontier.push_back(v);
+                }
+            }
+            bucket.clear();
+            if (frontier.empty()) {
+                break;
+            }
+            removed.insert(removed.end(), frontier.begin(), frontier.end());
+            ++stats_.phases;
+            relaxEdges(frontier, true);     // may refill this bucket
+        }
+        if (removed.empty()) {
+            continue;
+        }
+        std::sort(removed.begin(), removed.end());
+        removed.erase(std::unique(removed.begin(), removed.end()), removed.end());
+        relaxEdges(removed, false);
+        ++stats_.buckets;
+    }
+    stats_.relaxations = relaxations_.load();
+}
+
+// Distance from the last source
+double DeltaStepping::distance(uint32_t node) const {
+    return fromBits(distance_[node].load(std::memory_order_relaxed));
+}
+
+// Copy out all distances
+std::vector<double> DeltaStepping::distances() const {
+    std::vector<double> result(nodeCount_);
+    for (size_t v = 0; v < nodeCount_; ++v) {
+        result[v] = distance(static_cast<uint32_t>(v));
+    }
+    return result;
+}
+
+/**
+ * @brief Shortest-path tree from the final distances
+ *
+ * Breadth-first over tight edges (d(u) + w == d(v) exactly) from the
+ * source; the first tight edge reaching a node becomes its parent. Going
+ * outward from the source keeps zero-weight cycles from forming loops.
+ */
+std::vector<uint32_t> DeltaStepping::parents() const {
+    std::vector<uint32_t> parent(nodeCount_, NONE);
+    if (source_ >= nodeCount_) {
+        return parent;
+    }
+    std::vector<bool> visited(nodeCount_, false);
+    std::vector<uint32_t> queue(1, source_);
+    visited[source_] = true;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        uint32_t u = queue[head];
+        double du = distance(u);
+        for (const CSREdge& edge : graph_.neighbors(u)) {
+            // Closed edges are skipped: INF + INF would match an unreachable target
+            if (edge.weight == INF || visited[edge.target]) {
+                continue;
+            }
+            if (du + edge.weight == distance(edge.target)) {
+                visited[edge.target] = true;
+                parent[edge.target] = u;
+                queue.push_back(edge.target);
+            }
+        }
+    }
+    return parent;
+}
+
+// Counters
+const DeltaStepping::Stats& DeltaStepping::getStats() const {
+    return stats_;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file DeltaStepping.h
+ * @brief Parallel single-source shortest paths by Delta-stepping.
+ *
+ * Tentative distances are grouped into buckets of width Delta. The lowest
+ * non-empty bucket is processed in phases: all of its nodes relax their
+ * light edges (weight <= Delta) in parallel, which may refill the same
+ * bucket, until it stays empty; then the heavy edges of every node the
+ * bucket held are relaxed once. Within a phase threads lower distances
+ * with an atomic compare-and-swap minimum, so the order of updates does
+ * not matter.
+ *
+ * The result is the same fixed point Dijkstra reaches: every distance is
+ * the minimum, over paths, of the weights summed from the source in path
+ * order, so the values are bit-for-bit identical to a sequential search.
+ * Parents are derived afterwards from the final distances.
+ */
+
+#ifndef DELTA_STEPPING_H
+#define DELTA_STEPPING_H
+
+#include "Location.h"
+#include "CSRGraph.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class DeltaStepping
+ * @brief Full shortest-path tree from one source, relaxed in parallel
+ *
+ * Example usage:
+ * @code
+ * DeltaStepping search(csr, &pool);
+ * search.run(source);                 // Delta tuned from the weights
+ * double d = search.distance(target);
+ * @endcode
+ */
+class DeltaStepping {
+public:
+    /**
+     * @struct Stats
+     * @brief Work done by the last run()
+     */
+    struct Stats {
+        double delta;           ///< Bucket width used
+        size_t buckets;         ///< Non-empty buckets processed
+        size_t phases;          ///< Light-edge phases (parallel steps)
+        size_t relaxations;     ///< Edges relaxed
+
+        Stats() : delta(0.0), buckets(0), phases(0), relaxations(0) {}
+    };
+
+    /// Frontiers smaller than this are relaxed on the calling thread
+    static const size_t SERIAL_FRONTIER = 256;
+
+private:
+    const CSRGraph<Location*>& graph_;                  ///< Routing graph
+    ThreadPool* pool_;                                  ///< Workers (null = sequential)
+    std::unique_ptr<std::atomic<uint64_t>[]> distance_; ///< Bit patterns of the distances
+    size_t nodeCount_;                                  ///< Size of distance_
+    std::vector<uint64_t> queuedIn_;                    ///< Bucket + 1 a node is queued in, 0 if none
+    std::vector<std::vector<uint32_t>> buckets_;        ///< Circular bucket array
+    std::vector<std::vector<uint32_t>> updates_;        ///< Improved nodes, one list per chunk
+    size_t pending_;                                    ///< Entries in buckets_ (including stale ones)
+    double delta_;                                      ///< Bucket width of the current run
+    std::atomic<size_t> relaxations_;                   ///< Relaxation counter of the current run
+    uint32_t source_;                                   ///< Source of the last run
+    Stats stats_;
+
+    /**
+     * @brief Lower a node's distance if dist is smaller (thread-safe)
+     * @return True if this call lowered it
+     */
+    bool relaxMin(uint32_t node, double dist);
+
+    /**
+     * @brief Absolute bucket index of a node's current distance
+     */
+    uint64_t bucketOf(uint32_t node) const;
+
+    /**
+     * @brief Relax the light or heavy edges of nodes, then queue the improved targets
+     */
+    void relaxEdges(const std::vector<uint32_t>& nodes, bool light);
+
+public:
+    /**
+     * @brief Constructor
+     * @param graph Routing graph (weights must be non-negative)
+     * @param pool Worker pool, or null to run sequentially
+     */
+    explicit DeltaStepping(const CSRGraph<Location*>& graph, ThreadPool* pool = nullptr);
+
+    /**
+     * @brief Bucket width derived from the edge weight distribution
+     *
+     * The larger of the median weight (so most edges are light and
+     * buckets stay busy) and maxWeight / average degree (the classic
+     * choice that bounds the number of re-relaxations per node).
+     */
+    static double autoDelta(const CSRGraph<Location*>& graph);
+
+    /**
+     * @brief Compute shortest distances from source to every node
+     * @param source Dense start index
+     * @param delta Bucket width (0 = autoDelta())
+     */
+    void run(uint32_t source, double delta = 0.0);
+
+    /**
+     * @brief Distance from the last source
+     * @return Distance, or infinity if unreachable
+     */
+    double distance(uint32_t node) const;
+
+    /**
+     * @brief All distances from the last source, indexed by dense index
+     */
+    std::vector<double> distances() const;
+
+    /**
+     * @brief Predecessor of every node on a shortest path from the last source
+     * @return Parent index per node; 0xFFFFFFFF for the source and unreachable nodes
+     */
+    std::vector<uint32_t> parents() const;
+
+    /**
+     * @brief Counters of the last run
+     */
+    const Stats& getStats() const;
+};
+
+#endif // DELTA_STEPPING_H
@@ -14,6 +14,7 @@
 #include <iomanip>
 #include <algorithm>
 #include <cmath>
+#include <map>
 
 // Constructor
 GUIHandler::GUIHandler(Navigator& navigator)
@@ -27,7 +28,9 @@ GUIHandler::GUIHandler(Navigator& navigator)
       viewOffset_(0.0f, 0.0f),
       isDragging_(false),
       dragStartPos_(0.0f, 0.0f),
-      dragStartOffset_(0.0f, 0.0f) {
+      dragStartOffset_(0.0f, 0.0f),
+      showIsochrone_(false),
+      isochroneOrigin_(nullptr) {
 }
 
 // Initialize GUI
@@ -91,21 +94,24 @@ void GUIHandler::handleEvents() {
                     continue;
                 }
 
-                // Check via control buttons
+                // Check via control buttons. Rows follow displayedVias_; up/down
+                // reorder the clicked list and are inactive while optimizing.
                 bool handledViaButton = false;
+                bool reorderable = !navigator_.getOptimizeViaOrder();
                 for (size_t vi = 0; vi < viaUpRects_.size(); ++vi) {
                     if (viaUpRects_[vi].contains(pixelPosF)) {
-                        if (vi > 0) std::swap(viaLocations_[vi], viaLocations_[vi-1]);
+                        if (reorderable && vi > 0 && vi < viaLocations_.size()) std::swap(viaLocations_[vi], viaLocations_[vi-1]);
                         handledViaButton = true;
                         break;
                     }
                     if (viaDownRects_[vi].contains(pixelPosF)) {
-                        if (vi + 1 < viaLocations_.size()) std::swap(viaLocations_[vi], viaLocations_[vi+1]);
+                        if (reorderable && vi + 1 < viaLocations_.size()) std::swap(viaLocations_[vi], viaLocations_[vi+1]);
                         handledViaButton = true;
                         break;
                     }
                     if (viaRemoveRects_[vi].contains(pixelPosF)) {
-                        viaLocations_.erase(viaLocations_.begin() + vi);
+                        auto it = std::find(viaLocations_.begin(), viaLocations_.end(), displayedVias_[vi]);
+                        if (it != viaLocations_.end()) viaLocations_.erase(it);
                         handledViaButton = true;
                         break;
                     }
@@ -242,6 +248,41 @@ void GUIHandler::handleEvents() {
                 }
             }
 
+            if (keyPress->code == sf::Keyboard::Key::I) {
+                showIsochrone_ = !showIsochrone_;
+                isochroneOrigin_ = nullptr;
+            }
+
+            if (keyPress->code == sf::Keyboard::Key::O) {
+                navigator_.setOptimizeViaOrder(!navigator_.getOptimizeViaOrder());
+                if (pathCalculated_ && !viaLocations_.empty()) {
+                    try {
+                        currentPath_ = navigator_.findPath(selectedStart_, selectedEnd_, viaLocations_);
+                        lastErrorMsg_.clear();
+                    } catch (const std::exception& e) { lastErrorMsg_ = e.what(); pathCalculated_ = false; }
+                }
+            }
+
+            // Close (or reopen) every path at the inspected location, e.g. a gate at night
+            if (keyPress->code == sf::Keyboard::Key::X && uiMode_ == UIMode::Explore && inspectedLocation_) {
+                try {
+                    auto neighbors = navigator_.getGraph().getNeighbors(inspectedLocation_);
+                    bool anyOpen = false;
+                    for (const auto& edge : neighbors) {
+                        if (!navigator_.isConnectionClosed(inspectedLocation_, edge.destination)) anyOpen = true;
+                    }
+                    for (const auto& edge : neighbors) {
+                        if (anyOpen) navigator_.closeConnection(inspectedLocation_, edge.destination);
+                        else navigator_.reopenConnection(inspectedLocation_, edge.destination);
+                    }
+                    isochroneOrigin_ = nullptr;
+                    if (pathCalculated_) {
+                        if (!viaLocations_.empty()) currentPath_ = navigator_.findPath(selectedStart_, selectedEnd_, viaLocations_);
+                        else currentPath_ = navigator_.findPath(selectedStart_, selectedEnd_);
+                    }
+                } catch (const std::exception& e) { lastErrorMsg_ = e.what(); pathCalculated_ = false; }
+            }
+
             if (keyPress->code == sf::Keyboard::Key::Escape) {
                 selectedStart_ = nullptr; selectedEnd_ = nullptr; pathCalculated_ = false;
             }
@@ -251,7 +292,32 @@ void GUIHandler::handleEvents() {
 
 // Update
 void GUIHandler::update() {
-    // Update logic if needed
+    // Show vias in the order the route actually visits them; the clicked
+    // order in viaLocations_ is kept for when optimizing is turned off
+    if (pathCalculated_ && navigator_.getOptimizeViaOrder() && !viaLocations_.empty()) {
+        displayedVias_ = navigator_.getLastViaOrder();
+    } else {
+        displayedVias_ = viaLocations_;
+    }
+
+    // Recompute the reachable region only when its origin or mode changes
+    if (showIsochrone_) {
+        Location* origin = (uiMode_ == UIMode::Explore) ? inspectedLocation_ : selectedStart_;
+        std::string mode = navigator_.getNavigationMode()->getModeName();
+        if (origin == nullptr) {
+            isochrone_ = Isochrone();
+            isochroneOrigin_ = nullptr;
+        } else if (origin != isochroneOrigin_ || mode != isochroneMode_) {
+            try {
+                isochrone_ = navigator_.reachableWithin(origin, ISOCHRONE_MINUTES);
+                isochroneOrigin_ = origin;
+                isochroneMode_ = mode;
+            } catch (const std::exception& e) {
+                lastErrorMsg_ = e.what();
+                showIsochrone_ = false;
+            }
+        }
+    }
 }
 
 // Render
@@ -267,6 +333,9 @@ void GUIHandler::render() {
     
     // Draw components in world space
     drawMap();
+    if (showIsochrone_) {
+        drawIsochrone();
+    }
     drawPaths();
     if (pathCalculated_) {
         drawRoute();
@@ -359,9 +428,9 @@ void GUIHandler::drawBuildings() {
 
         // If this location is a via (and we're in Navigation mode), draw an ordered badge
         if (uiMode_ == UIMode::Navigation) {
-            auto it = std::find(viaLocations_.begin(), viaLocations_.end(), loc);
-            if (it != viaLocations_.end()) {
-                int idx = static_cast<int>(std::distance(viaLocations_.begin(), it));
+            auto it = std::find(displayedVias_.begin(), displayedVias_.end(), loc);
+            if (it != displayedVias_.end()) {
+                int idx = static_cast<int>(std::distance(displayedVias_.begin(), it));
                 float br = 12.0f; // badge radius
                 // Badge center position (slightly left-top of marker, offset by badge index to prevent overlap)
                 float badgeCx = screenPos.x - MARKER_RADIUS - 12.0f - (idx * 28.0f);
@@ -392,14 +461,13 @@ void GUIHandler::drawPaths() {
     std::vector<Location*> locations = navigator_.getAllLocations();
     
     sf::Color pathColor(100, 150, 200, 180);
+    sf::Color closedColor(200, 70, 70, 180);
     
     for (Location* loc : locations) {
         sf::Vector2f pos1 = locationToScreen(loc);
         
-        // Get neighbors from graph (actual connections)
-        auto neighbors = navigator_.getGraph().getNeighbors(loc);
-        
-        for (const auto& edge : neighbors) {
+        // Borrow the neighbors from the graph (actual connections)
+        for (const auto& edge : navigator_.getGraph().neighbors(loc)) {
             Location* neighbor = edge.destination;
             sf::Vector2f pos2 = locationToScreen(neighbor);
             
@@ -413,13 +481,55 @@ void GUIHandler::drawPaths() {
                 connectionLine.setPosition(pos1);
                 float angle = std::atan2(dy, dx) * 180.0f / 3.14159265f;
                 connectionLine.setRotation(sf::degrees(angle));
-                connectionLine.setFillColor(pathColor);
+                connectionLine.setFillColor(navigator_.isConnectionClosed(loc, neighbor) ? closedColor : pathColor);
                 window_.draw(connectionLine);
             }
         }
     }
 }
 
+// Shade reachable region: whole edges inside the limit, partial edges up to it
+void GUIHandler::drawIsochrone() {
+    if (isochrone_.reachable.empty()) return;
+
+    std::map<Location*, double> reachedAt;
+    for (const ReachableLocation& r : isochrone_.reachable) {
+        reachedAt[r.location] = r.distanceMeters;
+    }
+
+    sf::Color regionColor(80, 200, 120, 90);
+    for (const ReachableLocation& r : isochrone_.reachable) {
+        sf::Vector2f pos1 = locationToScreen(r.location);
+        double remaining = isochrone_.distanceLimitMeters - r.distanceMeters;
+
+        for (const auto& edge : navigator_.getGraph().neighbors(r.location)) {
+            if (edge.weight <= 0.0 || navigator_.isConnectionClosed(r.location, edge.destination)) continue;
+            float fraction = static_cast<float>(std::min(1.0, remaining / edge.weight));
+            sf::Vector2f pos2 = locationToScreen(edge.destination);
+            sf::Vector2f direction = (pos2 - pos1) * fraction;
+            float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+            if (length <= 0.0f) continue;
+
+            sf::RectangleShape band(sf::Vector2f(length, 10.0f));
+            band.setOrigin(sf::Vector2f(0.0f, 5.0f));
+            band.setPosition(pos1);
+            float angleDeg = std::atan2(direction.y, direction.x) * 180.0f / 3.14159265f;
+            band.setRotation(sf::degrees(angleDeg));
+            band.setFillColor(regionColor);
+            window_.draw(band);
+        }
+
+        // Halo fades with arrival time
+        float share = isochrone_.budgetMinutes > 0.0
+            ? static_cast<float>(r.arrivalMinutes / isochrone_.budgetMinutes) : 0.0f;
+        float radius = MARKER_RADIUS * 2.5f;
+        sf::CircleShape halo(radius);
+        halo.setPosition(sf::Vector2f(pos1.x - radius, pos1.y - radius));
+        halo.setFillColor(sf::Color(80, 200, 120, static_cast<std::uint8_t>(140 - 100 * std::min(1.0f, share))));
+        window_.draw(halo);
+    }
+}
+
 // Draw calculated route
 void GUIHandler::drawRoute() {
     if (currentPath_.empty()) return;
@@ -475,7 +585,12 @@ void GUIHandler::drawInfoPanel() {
     // Always show the navigation mode used for route calculation
     ss << "Nav Mode: " << navigator_.getNavigationMode()->getModeName() << "\n";
     ss << "Press W for Walking\n";
-    ss << "Press C for Cycling\n\n";
+    ss << "Press C for Cycling\n";
+    ss << "Reachable in " << ISOCHRONE_MINUTES << " min: "
+       << (showIsochrone_ ? std::to_string(isochrone_.reachable.size()) + " places" : "off")
+       << " (Press I)\n";
+    ss << "Via order: " << (navigator_.getOptimizeViaOrder() ? "Shortest" : "As clicked")
+       << " (Press O)\n\n";
 
     if (uiMode_ == UIMode::Explore) {
         if (inspectedLocation_) {
@@ -485,6 +600,7 @@ void GUIHandler::drawInfoPanel() {
                << inspectedLocation_->getLatitude() << ", "
                << inspectedLocation_->getLongitude() << "\n\n";
             ss << "Description:\n" << inspectedLocation_->getDescription() << "\n";
+            ss << "\nPress X to close/reopen its paths\n";
         } else {
             ss << "Explore mode active. Click a building to view details.\n";
         }
@@ -503,11 +619,11 @@ void GUIHandler::drawInfoPanel() {
         }
 
         // List any via waypoints
-        if (!viaLocations_.empty()) {
+        if (!displayedVias_.empty()) {
             ss << "\nVia: ";
-            for (size_t i = 0; i < viaLocations_.size(); ++i) {
-                ss << viaLocations_[i]->getName();
-                if (i + 1 < viaLocations_.size()) ss << ", ";
+            for (size_t i = 0; i < displayedVias_.size(); ++i) {
+                ss << displayedVias_[i]->getName();
+                if (i + 1 < displayedVias_.size()) ss << ", ";
             }
             ss << "\n";
         }
@@ -532,9 +648,10 @@ void GUIHandler::drawInfoPanel() {
     float listX = static_cast<float>(WINDOW_WIDTH - INFO_PANEL_WIDTH + 10);
     float listY = 220.0f;
     float entryH = 35.0f;
-    if (uiMode_ == UIMode::Navigation && !viaLocations_.empty()) {
-        for (size_t i = 0; i < viaLocations_.size(); ++i) {
-            Location* v = viaLocations_[i];
+    bool reorderable = !navigator_.getOptimizeViaOrder();
+    if (uiMode_ == UIMode::Navigation && !displayedVias_.empty()) {
+        for (size_t i = 0; i < displayedVias_.size(); ++i) {
+            Location* v = displayedVias_[i];
             // Draw via name
             sf::Text vText(font_, std::to_string(i+1) + ". " + v->getName(), 12u);
             vText.setFillColor(sf::Color::White);
@@ -550,7 +667,7 @@ void GUIHandler::drawInfoPanel() {
             // Up button
             sf::RectangleShape upBtn(sf::Vector2f(bw, bh));
             upBtn.setPosition(sf::Vector2f(bx, by));
-            upBtn.setFillColor(i == 0 ? sf::Color(80,80,80) : sf::Color(90,140,180));
+            upBtn.setFillColor(i == 0 || !reorderable ? sf::Color(80,80,80) : sf::Color(90,140,180));
             upBtn.setOutlineColor(sf::Color::White);
             upBtn.setOutlineThickness(1);
             window_.draw(upBtn);
@@ -563,7 +680,7 @@ void GUIHandler::drawInfoPanel() {
             // Down button
             sf::RectangleShape downBtn(sf::Vector2f(bw, bh));
             downBtn.setPosition(sf::Vector2f(bx + bw + 8.0f, by));
-            downBtn.setFillColor(i + 1 == viaLocations_.size() ? sf::Color(80,80,80) : sf::Color(90,140,180));
+            downBtn.setFillColor(i + 1 == displayedVias_.size() || !reorderable ? sf::Color(80,80,80) : sf::Color(90,140,180));
             downBtn.setOutlineColor(sf::Color::White);
             downBtn.setOutlineThickness(1);
             window_.draw(downBtn);
@@ -590,7 +707,7 @@ void GUIHandler::drawInfoPanel() {
 
     // Draw distance and time even when there are no vias (if a path was calculated)
     if (uiMode_ == UIMode::Navigation && pathCalculated_) {
-        float distY = listY + viaLocations_.size() * entryH + 10.0f;
+        float distY = listY + displayedVias_.size() * entryH + 10.0f;
         sf::Text distText(font_, "Distance: " + std::to_string(static_cast<int>(currentPath_.getTotalDistance())) + "m", 12u);
         distText.setFillColor(sf::Color::White);
         distText.setPosition(sf::Vector2f(listX, distY));
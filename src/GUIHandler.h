@@ -35,6 +35,7 @@ private:
     UIMode uiMode_;                      ///< Current UI mode
     Location* inspectedLocation_;       ///< Location selected in Explore mode
     std::vector<Location*> viaLocations_; ///< Ordered vias selected in Navigation mode
+    std::vector<Location*> displayedVias_; ///< Vias in the order the route visits them
     // Screen-space rect of the toggle button (updated each frame in drawInfoPanel)
     sf::FloatRect toggleButtonScreenRect_;
     // Screen-space rects for via controls (up/down/remove) per via entry
@@ -51,11 +52,18 @@ private:
     sf::Vector2f dragStartPos_;         ///< World pos where drag started
     sf::Vector2f dragStartOffset_;      ///< viewOffset_ value when drag started
     
+    // Isochrone overlay state
+    bool showIsochrone_;                ///< Whether the reachable region is shaded
+    Isochrone isochrone_;               ///< Last computed reachable region
+    Location* isochroneOrigin_;         ///< Origin isochrone_ was computed for
+    std::string isochroneMode_;         ///< Mode isochrone_ was computed for
+    
     // UI constants
     static const int WINDOW_WIDTH = 1200;
     static const int WINDOW_HEIGHT = 800;
     static const int MARKER_RADIUS = 8;
     static const int INFO_PANEL_WIDTH = 300;
+    static const int ISOCHRONE_MINUTES = 5;
     // Error message to display in info panel
     std::string lastErrorMsg_;
     
@@ -79,6 +87,11 @@ private:
      */
     void drawRoute();
     
+    /**
+     * @brief Shade the region reachable within ISOCHRONE_MINUTES
+     */
+    void drawIsochrone();
+    
     /**
      * @brief Draw info panel
      */
@@ -20,21 +20,60 @@
 
 #include <map>
 #include <vector>
+#include <unordered_map>
+#include <functional>
+#include <limits>
 #include <stdexcept>
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @struct FixedPointWeight
+ * @brief Non-negative edge weight stored as a 32-bit integer count of 1/Scale units
+ * 
+ * With Scale = 100 a metre weight keeps centimetre resolution and reaches
+ * about 42,900 km. Negative values clamp to zero; values past the range
+ * (including infinity) clamp to the largest representable weight, which
+ * reads back as infinity so closed edges survive a round trip.
+ */
+template<uint32_t Scale>
+struct FixedPointWeight {
+    uint32_t units;     ///< Weight in 1/Scale steps
+    
+    FixedPointWeight() : units(0) {}
+    
+    explicit FixedPointWeight(double value) {
+        double scaled = std::floor(value * Scale + 0.5);
+        if (!(scaled > 0.0)) {
+            units = 0;
+        } else if (scaled >= static_cast<double>(UINT32_MAX)) {
+            units = UINT32_MAX;
+        } else {
+            units = static_cast<uint32_t>(scaled);
+        }
+    }
+    
+    operator double() const {
+        return units == UINT32_MAX ? std::numeric_limits<double>::infinity()
+                                   : static_cast<double>(units) / Scale;
+    }
+};
 
 /**
  * @struct Edge
  * @brief Represents a weighted edge in the graph
  * 
- * TEMPLATE: Generic edge structure
+ * TEMPLATE: Generic edge structure. W is the stored weight type: double
+ * by default, or float / FixedPointWeight<> to halve the edge record when
+ * T is itself a 32-bit node index.
  */
-template<typename T>
+template<typename T, typename W = double>
 struct Edge {
     T destination;      ///< Destination node
-    double weight;      ///< Edge weight (distance)
+    W weight;           ///< Edge weight (distance)
     
-    Edge(T dest, double w) : destination(dest), weight(w) {}
+    Edge(T dest, W w) : destination(dest), weight(w) {}
 };
 
 /**
@@ -51,19 +90,104 @@ struct Edge {
  * Graph<Location*> campusGraph;
  * campusGraph.addNode(loc1);
  * campusGraph.addEdge(loc1, loc2, 100.5);
+ * 
+ * // 8-byte edges: 32-bit node indices, float weights
+ * Graph<uint32_t, float> compact;
  * @endcode
+ * 
+ * The API always takes and returns weights as double; W only decides
+ * how they are stored, so a narrower W rounds each weight once on insert.
  */
-template<typename T>
+template<typename T, typename W = double>
 class Graph {
+public:
+    /**
+     * @struct EdgeRange
+     * @brief Non-owning [begin, end) view over one node's stored edges
+     * 
+     * Borrows the graph's own storage, so iterating allocates nothing.
+     * Valid until the graph is next modified.
+     */
+    struct EdgeRange {
+        const Edge<T, W>* first;
+        const Edge<T, W>* last;
+        
+        const Edge<T, W>* begin() const { return first; }
+        const Edge<T, W>* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool empty() const { return first == last; }
+    };
+    
 private:
     // Adjacency list representation: node -> list of edges
-    std::map<T, std::vector<Edge<T>>> adjacencyList_;
+    std::map<T, std::vector<Edge<T, W>>> adjacencyList_;
+    
+    // Reverse index: node -> incoming edges, each stored with the source
+    // as destination. Kept in step with adjacencyList_ so removing a node
+    // only visits its own neighbors.
+    std::map<T, std::vector<Edge<T, W>>> incoming_;
+    
+    /**
+     * @struct EdgeKeyHash
+     * @brief Hash of a (from, to) node pair
+     */
+    struct EdgeKeyHash {
+        size_t operator()(const std::pair<T, T>& key) const {
+            size_t h = std::hash<T>()(key.first);
+            return h ^ (std::hash<T>()(key.second) + 0x9e3779b9 + (h << 6) + (h >> 2));
+        }
+    };
+    
+    // Optional (from, to) -> weight of the first such edge, for O(1)
+    // hasEdge/getEdgeWeight on high-degree nodes
+    std::unordered_map<std::pair<T, T>, W, EdgeKeyHash> edgeIndex_;
+    bool edgeIndexEnabled_;
+    
+    // Bumped by every mutation so derived data (CSR copies, route caches)
+    // can tell when it is stale
+    unsigned long long version_;
     
 public:
     /**
      * @brief Default constructor
      */
-    Graph() {}
+    Graph() : edgeIndexEnabled_(false), version_(0) {}
+    
+    /**
+     * @brief Get the mutation counter
+     * @return Value that changes whenever nodes or edges change
+     */
+    unsigned long long getVersion() const {
+        return version_;
+    }
+    
+    /**
+     * @brief Turn the hashed (from, to) edge index on or off
+     * @param enabled True builds the index from the current edges
+     * 
+     * Costs one hash entry per distinct edge; worth it when hasEdge or
+     * getEdgeWeight run often on nodes with many neighbors.
+     */
+    void setEdgeIndexEnabled(bool enabled) {
+        edgeIndex_.clear();
+        edgeIndexEnabled_ = enabled;
+        if (enabled) {
+            for (const auto& pair : adjacencyList_) {
+                for (const Edge<T, W>& edge : pair.second) {
+                    edgeIndex_.insert(std::make_pair(std::make_pair(pair.first, edge.destination),
+                                                     edge.weight));
+                }
+            }
+        }
+    }
+    
+    /**
+     * @brief Check whether the hashed edge index is maintained
+     * @return True if enabled
+     */
+    bool isEdgeIndexEnabled() const {
+        return edgeIndexEnabled_;
+    }
     
     /**
      * @brief Add a node to the graph
@@ -71,7 +195,9 @@ public:
      */
     void addNode(T node) {
         if (adjacencyList_.find(node) == adjacencyList_.end()) {
-            adjacencyList_[node] = std::vector<Edge<T>>();
+            adjacencyList_[node] = std::vector<Edge<T, W>>();
+            incoming_[node] = std::vector<Edge<T, W>>();
+            ++version_;
         }
     }
     
@@ -87,7 +213,14 @@ public:
         addNode(to);
         
         // Add edge
-        adjacencyList_[from].push_back(Edge<T>(to, weight));
+        const W stored = static_cast<W>(weight);
+        adjacencyList_[from].push_back(Edge<T, W>(to, stored));
+        incoming_[to].push_back(Edge<T, W>(from, stored));
+        if (edgeIndexEnabled_) {
+            // insert() keeps an existing entry, matching the first-edge-wins scan
+            edgeIndex_.insert(std::make_pair(std::make_pair(from, to), stored));
+        }
+        ++version_;
     }
     
     /**
@@ -104,14 +237,45 @@ public:
     /**
      * @brief Get all neighbors of a node
      * @param node Node to query
-     * @return Vector of edges to neighbors
+     * @return Copy of the edges to neighbors (see neighbors() for loops)
      */
-    std::vector<Edge<T>> getNeighbors(T node) const {
+    std::vector<Edge<T, W>> getNeighbors(T node) const {
         auto it = adjacencyList_.find(node);
         if (it != adjacencyList_.end()) {
             return it->second;
         }
-        return std::vector<Edge<T>>();
+        return std::vector<Edge<T, W>>();
+    }
+    
+    /**
+     * @brief Get all edges pointing to a node (for backward searches)
+     * @param node Node to query
+     * @return Reversed edges: destination is the source node of each edge
+     */
+    std::vector<Edge<T, W>> getIncoming(T node) const {
+        auto it = incoming_.find(node);
+        if (it != incoming_.end()) {
+            return it->second;
+        }
+        return std::vector<Edge<T, W>>();
+    }
+    
+    /**
+     * @brief Borrow the outgoing edges of a node without copying
+     * @param node Node to query
+     * @return Range over the stored edges; empty if the node is unknown
+     */
+    EdgeRange neighbors(T node) const {
+        return rangeOf(adjacencyList_, node);
+    }
+    
+    /**
+     * @brief Borrow the incoming edges of a node without copying
+     * @param node Node to query
+     * @return Range of reversed edges (destination is the source node)
+     */
+    EdgeRange incoming(T node) const {
+        return rangeOf(incoming_, node);
     }
     
     /**
@@ -130,12 +294,16 @@ public:
      * @return True if edge exists
      */
     bool hasEdge(T from, T to) const {
+        if (edgeIndexEnabled_) {
+            return edgeIndex_.count(std::make_pair(from, to)) > 0;
+        }
+        
         auto it = adjacencyList_.find(from);
         if (it == adjacencyList_.end()) {
             return false;
         }
         
-        for (const Edge<T>& edge : it->second) {
+        for (const Edge<T, W>& edge : it->second) {
             if (edge.destination == to) {
                 return true;
             }
@@ -151,20 +319,65 @@ public:
      * @throws std::runtime_error if edge doesn't exist
      */
     double getEdgeWeight(T from, T to) const {
+        if (edgeIndexEnabled_) {
+            auto found = edgeIndex_.find(std::make_pair(from, to));
+            if (found != edgeIndex_.end()) {
+                return static_cast<double>(found->second);
+            }
+            if (!hasNode(from)) {
+                throw std::runtime_error("Source node not found in graph");
+            }
+            throw std::runtime_error("Edge not found in graph");
+        }
+        
         auto it = adjacencyList_.find(from);
         if (it == adjacencyList_.end()) {
             throw std::runtime_error("Source node not found in graph");
         }
         
-        for (const Edge<T>& edge : it->second) {
+        for (const Edge<T, W>& edge : it->second) {
             if (edge.destination == to) {
-                return edge.weight;
+                return static_cast<double>(edge.weight);
             }
         }
         
         throw std::runtime_error("Edge not found in graph");
     }
     
+    /**
+     * @brief Get the weights of many edges at once
+     * @param pairs (from, to) pairs to look up
+     * @return One weight per pair; infinity where the edge does not exist
+     * 
+     * Unlike getEdgeWeight(), missing edges do not throw, so a whole
+     * validation batch can be checked in one call.
+     */
+    std::vector<double> getEdgeWeights(const std::vector<std::pair<T, T>>& pairs) const {
+        std::vector<double> weights;
+        weights.reserve(pairs.size());
+        for (const std::pair<T, T>& key : pairs) {
+            double weight = std::numeric_limits<double>::infinity();
+            if (edgeIndexEnabled_) {
+                auto found = edgeIndex_.find(key);
+                if (found != edgeIndex_.end()) {
+                    weight = static_cast<double>(found->second);
+                }
+            } else {
+                auto it = adjacencyList_.find(key.first);
+                if (it != adjacencyList_.end()) {
+                    for (const Edge<T, W>& edge : it->second) {
+                        if (edge.destination == key.second) {
+                            weight = static_cast<double>(edge.weight);
+                            break;
+                        }
+                    }
+                }
+            }
+            weights.push_back(weight);
+        }
+        return weights;
+    }
+    
     /**
      * @brief Get all nodes in graph
      * @return Vector of all nodes
@@ -202,24 +415,41 @@ public:
      */
     void clear() {
         adjacencyList_.clear();
+        incoming_.clear();
+        edgeIndex_.clear();
+        ++version_;
     }
     
     /**
      * @brief Remove a node from graph
      * @param node Node to remove
+     * 
+     * Uses the reverse index, so the cost is proportional to the node's
+     * degree and its neighbors' degrees rather than to the whole graph.
      */
     void removeNode(T node) {
-        adjacencyList_.erase(node);
+        auto out = adjacencyList_.find(node);
+        if (out == adjacencyList_.end()) {
+            return;
+        }
+        ++version_;
+        
+        // Drop this node from the reverse index of everything it points to
+        for (const Edge<T, W>& edge : out->second) {
+            edgeIndex_.erase(std::make_pair(node, edge.destination));
+            if (edge.destination == node) continue;     // self-loop, erased below
+            eraseEdgesTo(incoming_[edge.destination], node);
+        }
         
         // Remove all edges pointing to this node
-        for (auto& pair : adjacencyList_) {
-            auto& edges = pair.second;
-            edges.erase(
-                std::remove_if(edges.begin(), edges.end(),
-                    [node](const Edge<T>& e) { return e.destination == node; }),
-                edges.end()
-            );
+        for (const Edge<T, W>& edge : incoming_[node]) {
+            edgeIndex_.erase(std::make_pair(edge.destination, node));
+            if (edge.destination == node) continue;
+            eraseEdgesTo(adjacencyList_[edge.destination], node);
         }
+        
+        adjacencyList_.erase(out);
+        incoming_.erase(node);
     }
     
     /**
@@ -228,16 +458,42 @@ public:
      * @param to Destination node
      */
     void removeEdge(T from, T to) {
+        ++version_;
         auto it = adjacencyList_.find(from);
         if (it != adjacencyList_.end()) {
-            auto& edges = it->second;
-            edges.erase(
-                std::remove_if(edges.begin(), edges.end(),
-                    [to](const Edge<T>& e) { return e.destination == to; }),
-                edges.end()
-            );
+            eraseEdgesTo(it->second, to);
+            edgeIndex_.erase(std::make_pair(from, to));
+            auto in = incoming_.find(to);
+            if (in != incoming_.end()) {
+                eraseEdgesTo(in->second, from);
+            }
         }
     }
+    
+private:
+    /**
+     * @brief Range over the edge list of node in one of the adjacency maps
+     */
+    static EdgeRange rangeOf(const std::map<T, std::vector<Edge<T, W>>>& lists, T node) {
+        EdgeRange range = { nullptr, nullptr };
+        auto it = lists.find(node);
+        if (it != lists.end() && !it->second.empty()) {
+            range.first = it->second.data();
+            range.last = range.first + it->second.size();
+        }
+        return range;
+    }
+    
+    /**
+     * @brief Erase every edge in a list whose destination is node
+     */
+    static void eraseEdgesTo(std::vector<Edge<T, W>>& edges, T node) {
+        edges.erase(
+            std::remove_if(edges.begin(), edges.end(),
+                [node](const Edge<T, W>& e) { return e.destination == node; }),
+            edges.end()
+        );
+    }
 };
 
 #endif // GRAPH_H
@@ -0,0 +1,420 @@
+/**
+ * @file GraphSnapshot.cpp
+ * @brief Writing and memory-mapping routing graph snapshots.
+ */
+
+#include "GraphSnapshot.h"
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cstdio>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MAGIC[8] = { 'C', 'N', 'A', 'V', 'S', 'N', 'A', 'P' };
+const uint32_t BYTE_ORDER_MARK = 0x01020304u;
+
+// Section indices in Header::sections
+enum Section {
+    NODES, OFFSETS, EDGES, IN_OFFSETS, IN_EDGES, IN_POSITION, STRINGS, SECTION_COUNT
+};
+
+/**
+ * @struct Header
+ * @brief Fixed 128-byte file header
+ */
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;                 ///< BYTE_ORDER_MARK as stored by the writer
+    uint64_t fileSize;
+    uint64_t nodeCount;
+    uint64_t edgeCount;
+    uint64_t stringBytes;
+    double maxEdgeWeight;
+    double heuristicScale;
+    uint64_t sections[SECTION_COUNT];   ///< Byte offset of each section
+    uint64_t checksum;                  ///< FNV-1a of bytes [sizeof(Header), fileSize)
+};
+
+static_assert(sizeof(Header) == 128, "snapshot header layout changed");
+static_assert(sizeof(SnapshotNode) == 32, "snapshot node layout changed");
+static_assert(sizeof(CSREdge) == 16, "CSR edge layout changed");
+
+const uint64_t FNV_OFFSET = 14695981039346656037ull;
+const uint64_t FNV_PRIME = 1099511628211ull;
+
+uint64_t fnv1a(uint64_t hash, const unsigned char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+uint64_t align8(uint64_t offset) {
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+// Byte size of each section for the given counts
+void sectionSizes(uint64_t nodes, uint64_t edges, uint64_t strings, uint64_t* sizes) {
+    sizes[NODES] = nodes * sizeof(SnapshotNode);
+    sizes[OFFSETS] = (nodes + 1) * sizeof(uint32_t);
+    sizes[EDGES] = edges * sizeof(CSREdge);
+    sizes[IN_OFFSETS] = (nodes + 1) * sizeof(uint32_t);
+    sizes[IN_EDGES] = edges * sizeof(CSREdge);
+    sizes[IN_POSITION] = edges * sizeof(uint32_t);
+    sizes[STRINGS] = strings;
+}
+
+/**
+ * @class ChecksumWriter
+ * @brief Appends to the output stream, hashing and padding as it goes
+ */
+class ChecksumWriter {
+private:
+    std::ofstream& out_;
+    uint64_t position_;
+    uint64_t hash_;
+
+public:
+    ChecksumWriter(std::ofstream& out, uint64_t position)
+        : out_(out), position_(position), hash_(FNV_OFFSET) {}
+
+    void write(const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        out_.write(reinterpret_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+        hash_ = fnv1a(hash_, bytes, size);
+        position_ += size;
+    }
+
+    void padTo(uint64_t offset) {
+        static const unsigned char zeros[8] = { 0 };
+        if (offset > position_) {
+            write(zeros, static_cast<size_t>(offset - position_));
+        }
+    }
+
+    // Edges are copied with zeroed padding so equal graphs give equal files
+    void writeEdges(const CSREdge* edges, size_t count) {
+        std::vector<CSREdge> chunk;
+        const size_t CHUNK = 4096;
+        for (size_t first = 0; first < count; first += CHUNK) {
+            size_t n = std::min(CHUNK, count - first);
+            chunk.resize(n);
+            std::memset(chunk.data(), 0, n * sizeof(CSREdge));
+            for (size_t i = 0; i < n; ++i) {
+                chunk[i].target = edges[first + i].target;
+                chunk[i].weight = edges[first + i].weight;
+            }
+            write(chunk.data(), n * sizeof(CSREdge));
+        }
+    }
+
+    uint64_t hash() const { return hash_; }
+};
+
+} // namespace
+
+// Constructor
+GraphSnapshot::GraphSnapshot()
+    : base_(nullptr), size_(0), nodes_(nullptr), strings_(nullptr), stringBytes_(0),
+      arrays_(), maxEdgeWeight_(0.0), heuristicScale_(1.0)
+#ifdef _WIN32
+      , file_(nullptr), mapping_(nullptr)
+#endif
+{}
+
+// Destructor
+GraphSnapshot::~GraphSnapshot() {
+#ifdef _WIN32
+    if (base_ != nullptr) UnmapViewOfFile(base_);
+    if (mapping_ != nullptr) CloseHandle(mapping_);
+    if (file_ != nullptr) CloseHandle(file_);
+#else
+    if (base_ != nullptr) munmap(const_cast<unsigned char*>(base_), size_);
+#endif
+}
+
+/**
+ * @brief Serialize a routing graph
+ *
+ * Written to path + ".tmp" and renamed into place, so a reader never maps
+ * a half-written file and a snapshot that is currently mapped can be
+ * replaced.
+ */
+void GraphSnapshot::write(const std::string& path, const CSRGraph<Location*>& graph,
+                          double maxEdgeWeight, double heuristicScale) {
+    const CSRArrays arrays = graph.getArrays();
+
+    // Node table and string pool
+    std::vector<SnapshotNode> nodes(arrays.nodeCount);
+    std::string pool;
+    for (uint32_t i = 0; i < arrays.nodeCount; ++i) {
+        const Location* loc = graph.nodeAt(i);
+        SnapshotNode& node = nodes[i];
+        std::memset(&node, 0, sizeof(node));
+        node.id = loc->getId();
+        node.latitude = loc->getLatitude();
+        node.longitude = loc->getLongitude();
+        const std::string strings[] = { loc->getName(), loc->getDescription() };
+        uint32_t* slots[] = { &node.name, &node.description };
+        for (int s = 0; s < 2; ++s) {
+            if (pool.size() + strings[s].size() + 1 > std::numeric_limits<uint32_t>::max()) {
+                throw SnapshotFormatException("Snapshot string pool exceeds 4 GiB");
+            }
+            *slots[s] = static_cast<uint32_t>(pool.size());
+            pool.append(strings[s]);
+            pool.push_back('\0');
+        }
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.nodeCount = arrays.nodeCount;
+    header.edgeCount = arrays.edgeCount;
+    header.stringBytes = pool.size();
+    header.maxEdgeWeight = maxEdgeWeight;
+    header.heuristicScale = heuristicScale;
+    uint64_t sizes[SECTION_COUNT];
+    sectionSizes(header.nodeCount, header.edgeCount, header.stringBytes, sizes);
+    uint64_t position = sizeof(Header);
+    for (int s = 0; s < SECTION_COUNT; ++s) {
+        header.sections[s] = align8(position);
+        position = header.sections[s] + sizes[s];
+    }
+    header.fileSize = position;
+
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw SnapshotFormatException("Cannot create snapshot: " + temporary);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        const size_t n = arrays.nodeCount;
+        const size_t m = arrays.edgeCount;
+        ChecksumWriter writer(out, sizeof(Header));
+        writer.padTo(header.sections[NODES]);
+        writer.write(nodes.data(), n * sizeof(SnapshotNode));
+        writer.padTo(header.sections[OFFSETS]);
+        writer.write(arrays.offsets, (n + 1) * sizeof(uint32_t));
+        writer.padTo(header.sections[EDGES]);
+        writer.writeEdges(arrays.edges, m);
+        writer.padTo(header.sections[IN_OFFSETS]);
+        writer.write(arrays.inOffsets, (n + 1) * sizeof(uint32_t));
+        writer.padTo(header.sections[IN_EDGES]);
+        writer.writeEdges(arrays.inEdges, m);
+        writer.padTo(header.sections[IN_POSITION]);
+        writer.write(arrays.inPosition, m * sizeof(uint32_t));
+        writer.padTo(header.sections[STRINGS]);
+        writer.write(pool.data(), pool.size());
+
+        header.checksum = writer.hash();
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.flush();
+        if (!out) {
+            out.close();
+            std::remove(temporary.c_str());
+            throw SnapshotFormatException("Cannot write snapshot: " + temporary);
+        }
+    }
+#ifdef _WIN32
+    std::remove(path.c_str());      // rename() does not replace on Windows
+#endif
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw SnapshotFormatException("Cannot replace snapshot: " + path);
+    }
+}
+
+// Map the whole file read-only
+void GraphSnapshot::map(const std::string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw SnapshotFormatException("Cannot open snapshot: " + path);
+    }
+    file_ = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        throw SnapshotFormatException("Cannot map empty snapshot: " + path);
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ == nullptr) {
+        throw SnapshotFormatException("Cannot map snapshot: " + path);
+    }
+    base_ = static_cast<const unsigned char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (base_ == nullptr) {
+        throw SnapshotFormatException("Cannot map snapshot: " + path);
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw SnapshotFormatException("Cannot open snapshot: " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        throw SnapshotFormatException("Cannot map empty snapshot: " + path);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    void* address = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);    // the mapping keeps the file referenced
+    if (address == MAP_FAILED) {
+        size_ = 0;
+        throw SnapshotFormatException("Cannot map snapshot: " + path);
+    }
+    base_ = static_cast<const unsigned char*>(address);
+#endif
+}
+
+/**
+ * @brief Header, bounds and (optionally) checksum checks
+ *
+ * Every section must lie inside the file at an 8-byte boundary and the CSR
+ * offset arrays must start at 0 and end at the edge count. The checksum
+ * covers the rest: with it disabled a corrupted array body is not
+ * detected.
+ */
+void GraphSnapshot::validate(const std::string& path, bool verifyChecksum) {
+    if (size_ < sizeof(Header)) {
+        throw SnapshotFormatException("Snapshot is truncated: " + path);
+    }
+    Header header;
+    std::memcpy(&header, base_, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw SnapshotFormatException("Not a graph snapshot: " + path);
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        throw SnapshotFormatException("Snapshot was written with another byte order: " + path);
+    }
+    if (header.version != FORMAT_VERSION) {
+        throw SnapshotFormatException("Unsupported snapshot version " +
+                                      std::to_string(header.version) + ": " + path);
+    }
+    if (header.fileSize != size_) {
+        throw SnapshotFormatException("Snapshot is truncated: " + path);
+    }
+    const uint64_t limit = std::numeric_limits<uint32_t>::max();
+    if (header.nodeCount > limit || header.edgeCount > limit || header.stringBytes > limit) {
+        throw SnapshotFormatException("Snapshot counts out of range: " + path);
+    }
+    uint64_t sizes[SECTION_COUNT];
+    sectionSizes(header.nodeCount, header.edgeCount, header.stringBytes, sizes);
+    for (int s = 0; s < SECTION_COUNT; ++s) {
+        uint64_t offset = header.sections[s];
+        if (offset % 8 != 0 || offset < sizeof(Header) || offset > size_ || sizes[s] > size_ - offset) {
+            throw SnapshotFormatException("Snapshot section out of bounds: " + path);
+        }
+    }
+
+    if (verifyChecksum &&
+        fnv1a(FNV_OFFSET, base_ + sizeof(Header), size_ - sizeof(Header)) != header.checksum) {
+        throw SnapshotFormatException("Snapshot checksum mismatch: " + path);
+    }
+
+    nodes_ = reinterpret_cast<const SnapshotNode*>(base_ + header.sections[NODES]);
+    strings_ = reinterpret_cast<const char*>(base_ + header.sections[STRINGS]);
+    stringBytes_ = static_cast<size_t>(header.stringBytes);
+    arrays_.offsets = reinterpret_cast<const uint32_t*>(base_ + header.sections[OFFSETS]);
+    arrays_.edges = reinterpret_cast<const CSREdge*>(base_ + header.sections[EDGES]);
+    arrays_.inOffsets = reinterpret_cast<const uint32_t*>(base_ + header.sections[IN_OFFSETS]);
+    arrays_.inEdges = reinterpret_cast<const CSREdge*>(base_ + header.sections[IN_EDGES]);
+    arrays_.inPosition = reinterpret_cast<const uint32_t*>(base_ + header.sections[IN_POSITION]);
+    arrays_.nodeCount = static_cast<size_t>(header.nodeCount);
+    arrays_.edgeCount = static_cast<size_t>(header.edgeCount);
+    maxEdgeWeight_ = header.maxEdgeWeight;
+    heuristicScale_ = header.heuristicScale;
+
+    const size_t n = arrays_.nodeCount;
+    if (arrays_.offsets[0] != 0 || arrays_.offsets[n] != arrays_.edgeCount ||
+        arrays_.inOffsets[0] != 0 || arrays_.inOffsets[n] != arrays_.edgeCount) {
+        throw SnapshotFormatException("Snapshot CSR offsets are inconsistent: " + path);
+    }
+    if (stringBytes_ > 0 && strings_[stringBytes_ - 1] != '\0') {
+        throw SnapshotFormatException("Snapshot string pool is not terminated: " + path);
+    }
+}
+
+// Map and validate
+std::shared_ptr<const GraphSnapshot> GraphSnapshot::open(const std::string& path,
+                                                         bool verifyChecksum) {
+    std::shared_ptr<GraphSnapshot> snapshot(new GraphSnapshot());
+    snapshot->map(path);
+    snapshot->validate(path, verifyChecksum);
+    return snapshot;
+}
+
+// Node count
+size_t GraphSnapshot::getNodeCount() const {
+    return arrays_.nodeCount;
+}
+
+// Edge count
+size_t GraphSnapshot::getEdgeCount() const {
+    return arrays_.edgeCount;
+}
+
+// Node table entry
+const SnapshotNode& GraphSnapshot::node(uint32_t index) const {
+    return nodes_[index];
+}
+
+// Name from the pool
+const char* GraphSnapshot::name(uint32_t index) const {
+    uint32_t offset = nodes_[index].name;
+    if (offset >= stringBytes_) {
+        throw SnapshotFormatException("Snapshot name offset out of range");
+    }
+    return strings_ + offset;
+}
+
+// Description from the pool
+const char* GraphSnapshot::description(uint32_t index) const {
+    uint32_t offset = nodes_[index].description;
+    if (offset >= stringBytes_) {
+        throw SnapshotFormatException("Snapshot description offset out of range");
+    }
+    return strings_ + offset;
+}
+
+// Mapped CSR arrays
+const CSRArrays& GraphSnapshot::getArrays() const {
+    return arrays_;
+}
+
+// Stored routing constant
+double GraphSnapshot::getMaxEdgeWeight() const {
+    return maxEdgeWeight_;
+}
+
+// Stored routing constant
+double GraphSnapshot::getHeuristicScale() const {
+    return heuristicScale_;
+}
+
+// Mapped size
+size_t GraphSnapshot::getFileSize() const {
+    return size_;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file GraphSnapshot.h
+ * @brief Versioned binary snapshot of the routing graph, read via mmap.
+ *
+ * Building the Navigator from CampusData (or a large import) creates every
+ * Location, inserts every edge into the map-based Graph and freezes it into
+ * CSR form. A snapshot stores the result of that work once: a node table,
+ * the five CSR arrays and a pool of the node names and descriptions. The
+ * file is mapped read-only and the CSR arrays are used in place, so opening
+ * it costs one pass over the node table instead of a rebuild.
+ *
+ * Layout (little-endian, every section 8-byte aligned):
+ *
+ *   header | node table | offsets | edges | inOffsets | inEdges | inPosition | strings
+ *
+ * The header carries a magic, the format version, a byte-order mark, the
+ * section offsets and a 64-bit FNV-1a checksum of everything after it.
+ */
+
+#ifndef GRAPH_SNAPSHOT_H
+#define GRAPH_SNAPSHOT_H
+
+#include "Location.h"
+#include "CSRGraph.h"
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class SnapshotFormatException
+ * @brief Thrown when a snapshot file is missing, truncated, corrupt or of another version
+ */
+class SnapshotFormatException : public std::runtime_error {
+public:
+    explicit SnapshotFormatException(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+/**
+ * @struct SnapshotNode
+ * @brief One entry of the node table
+ */
+struct SnapshotNode {
+    int32_t id;             ///< Location::getId()
+    uint32_t name;          ///< Offset of the name in the string pool
+    uint32_t description;   ///< Offset of the description in the string pool
+    uint32_t reserved;      ///< Zero
+    double latitude;        ///< GPS latitude
+    double longitude;       ///< GPS longitude
+};
+
+/**
+ * @class GraphSnapshot
+ * @brief Read-only memory mapping of a snapshot file
+ *
+ * Example usage:
+ * @code
+ * GraphSnapshot::write("campus.snap", navigator.getRoutingGraph(), maxWeight, scale);
+ * std::shared_ptr<const GraphSnapshot> snap = GraphSnapshot::open("campus.snap");
+ * CSRArrays arrays = snap->getArrays();     // points into the mapped pages
+ * @endcode
+ */
+class GraphSnapshot {
+public:
+    /// Bumped whenever the layout changes; other versions are rejected
+    static const uint32_t FORMAT_VERSION = 1;
+
+private:
+    const unsigned char* base_;     ///< Start of the mapping
+    size_t size_;                   ///< Mapped bytes (whole file)
+    const SnapshotNode* nodes_;
+    const char* strings_;
+    size_t stringBytes_;
+    CSRArrays arrays_;
+    double maxEdgeWeight_;
+    double heuristicScale_;
+#ifdef _WIN32
+    void* file_;                    ///< HANDLE of the open file
+    void* mapping_;                 ///< HANDLE of the file mapping
+#endif
+
+    GraphSnapshot();
+    GraphSnapshot(const GraphSnapshot&);
+    GraphSnapshot& operator=(const GraphSnapshot&);
+
+    /**
+     * @brief Map a file read-only into base_/size_
+     */
+    void map(const std::string& path);
+
+    /**
+     * @brief Check the header and locate the sections
+     */
+    void validate(const std::string& path, bool verifyChecksum);
+
+public:
+    /**
+     * @brief Unmaps the file
+     */
+    ~GraphSnapshot();
+
+    /**
+     * @brief Write a routing graph to a snapshot file
+     * @param path Output file (overwritten)
+     * @param graph Routing graph; nodeAt(i) supplies row i of the node table
+     * @param maxEdgeWeight Largest finite edge weight, stored for the loader
+     * @param heuristicScale A* heuristic scale, stored for the loader
+     * @throws SnapshotFormatException if the file cannot be written or the
+     *         strings exceed the 4 GiB pool
+     */
+    static void write(const std::string& path, const CSRGraph<Location*>& graph,
+                      double maxEdgeWeight, double heuristicScale);
+
+    /**
+     * @brief Map a snapshot file
+     * @param path Snapshot file
+     * @param verifyChecksum Hash the whole file (reads every page once);
+     *        without it only the header and section bounds are checked
+     * @return Shared mapping; CSR graphs wrapping it keep it alive
+     * @throws SnapshotFormatException if the file is unreadable or invalid
+     */
+    static std::shared_ptr<const GraphSnapshot> open(const std::string& path,
+                                                     bool verifyChecksum = true);
+
+    /**
+     * @brief Get number of nodes
+     */
+    size_t getNodeCount() const;
+
+    /**
+     * @brief Get number of directed edges
+     */
+    size_t getEdgeCount() const;
+
+    /**
+     * @brief Get a node table entry
+     * @param index Dense node index
+     */
+    const SnapshotNode& node(uint32_t index) const;
+
+    /**
+     * @brief Get a node's name from the string pool
+     */
+    const char* name(uint32_t index) const;
+
+    /**
+     * @brief Get a node's description from the string pool
+     */
+    const char* description(uint32_t index) const;
+
+    /**
+     * @brief Get the CSR arrays inside the mapping
+     */
+    const CSRArrays& getArrays() const;
+
+    /**
+     * @brief Largest finite edge weight recorded by write()
+     */
+    double getMaxEdgeWeight() const;
+
+    /**
+     * @brief A* heuristic scale recorded by write()
+     */
+    double getHeuristicScale() const;
+
+    /**
+     * @brief Size of the mapped file in bytes
+     */
+    size_t getFileSize() const;
+};
+
+#endif // GRAPH_SNAPSHOT_H
@@ -0,0 +1,295 @@
+/**
+ * @file KShortestPaths.cpp
+ * @brief Implementation of Yen's algorithm and the penalty method.
+ */
+
+#include "KShortestPaths.h"
+#include <limits>
+#include <algorithm>
+#include <set>
+
+namespace {
+
+const double INF = std::numeric_limits<double>::infinity();
+
+// The penalty method gives up after this many searches per requested route
+const size_t PENALTY_ATTEMPTS_PER_ROUTE = 3;
+
+// Ascending by length
+bool shorter(const KShortestPaths::Route& a, const KShortestPaths::Route& b) {
+    return a.distance < b.distance;
+}
+
+} // namespace
+
+// Constructor
+KShortestPaths::KShortestPaths(const CSRGraph<Location*>& graph,
+                               SearchWorkspace& forward, SearchWorkspace& tree)
+    : graph_(graph), forward_(forward), tree_(tree) {}
+
+// Cheapest parallel edge
+double KShortestPaths::edgeWeight(uint32_t from, uint32_t to) const {
+    double best = INF;
+    for (const CSREdge& edge : graph_.neighbors(from)) {
+        if (edge.target == to && edge.weight < best) {
+            best = edge.weight;
+        }
+    }
+    return best;
+}
+
+// Sum counters
+void KShortestPaths::accumulate(const SearchStats& stats) {
+    stats_.nodesSettled += stats.nodesSettled;
+    stats_.edgesRelaxed += stats.edgesRelaxed;
+    stats_.allocations += stats.allocations;
+}
+
+// Counters
+const SearchStats& KShortestPaths::getStats() const {
+    return stats_;
+}
+
+// Full backward Dijkstra: tree_.distance(v) = d(v, target),
+// tree_.previous(v) = next hop from v towards target
+void KShortestPaths::buildTree(uint32_t target) {
+    tree_.begin(graph_.getNodeCount());
+    tree_.setDistance(target, 0.0, SearchWorkspace::NO_NODE);
+    tree_.push(0.0, target);
+    while (!tree_.empty()) {
+        SearchWorkspace::QueueEntry top = tree_.pop();
+        uint32_t current = top.second;
+        if (tree_.isSettled(current)) {
+            continue;
+        }
+        tree_.settle(current);
+        for (const CSREdge& edge : graph_.incoming(current)) {
+            if (tree_.relax(edge.target, top.first + edge.weight, current)) {
+                tree_.push(top.first + edge.weight, edge.target);
+            }
+        }
+    }
+    accumulate(tree_.getStats());
+}
+
+/**
+ * @brief Spur search reusing the backward tree
+ *
+ * Blocked nodes are pre-marked as settled so the search never enters them.
+ * The tree distance is a lower bound on the remaining distance in the
+ * restricted graph (blocking only removes options), so A* with it stays
+ * exact; when nothing on the tree path is blocked the tree path itself is
+ * the answer and no search runs at all.
+ */
+double KShortestPaths::spurPath(uint32_t spur, uint32_t target,
+                                const std::vector<uint32_t>& blockedNodes,
+                                const std::vector<uint32_t>& blockedNext,
+                                std::vector<uint32_t>& out) {
+    out.clear();
+    if (!tree_.reached(spur)) {
+        return INF;
+    }
+
+    // Fast path: follow the tree if it avoids every blocked node and hop
+    uint32_t firstHop = tree_.previous(spur);
+    bool treeUsable = firstHop == SearchWorkspace::NO_NODE ||
+        std::find(blockedNext.begin(), blockedNext.end(), firstHop) == blockedNext.end();
+    for (uint32_t v = firstHop; treeUsable && v != SearchWorkspace::NO_NODE; v = tree_.previous(v)) {
+        if (std::find(blockedNodes.begin(), blockedNodes.end(), v) != blockedNodes.end()) {
+            treeUsable = false;
+        }
+    }
+    if (treeUsable) {
+        for (uint32_t v = spur; v != SearchWorkspace::NO_NODE; v = tree_.previous(v)) {
+            out.push_back(v);
+        }
+        return tree_.distance(spur);
+    }
+
+    // A* towards target with the exact unrestricted distance as heuristic
+    forward_.begin(graph_.getNodeCount());
+    for (uint32_t v : blockedNodes) {
+        forward_.settle(v);
+    }
+    forward_.setDistance(spur, 0.0, SearchWorkspace::NO_NODE);
+    forward_.push(tree_.distance(spur), spur);
+    while (!forward_.empty()) {
+        uint32_t current = forward_.pop().second;
+        if (forward_.isSettled(current)) {
+            continue;
+        }
+        forward_.settle(current);
+        if (current == target) {
+            break;
+        }
+        double currentDist = forward_.distance(current);
+        for (const CSREdge& edge : graph_.neighbors(current)) {
+            if (forward_.isSettled(edge.target) || !tree_.reached(edge.target)) {
+                continue;   // blocked, done, or cannot reach target at all
+            }
+            if (current == spur &&
+                std::find(blockedNext.begin(), blockedNext.end(), edge.target) != blockedNext.end()) {
+                continue;
+            }
+            double tentativeDist = currentDist + edge.weight;
+            if (forward_.relax(edge.target, tentativeDist, current)) {
+                forward_.push(tentativeDist + tree_.distance(edge.target), edge.target);
+            }
+        }
+    }
+    accumulate(forward_.getStats());
+
+    if (!forward_.isSettled(target) || !forward_.reached(target)) {
+        return INF;
+    }
+    for (uint32_t v = target; v != SearchWorkspace::NO_NODE; v = forward_.previous(v)) {
+        out.push_back(v);
+    }
+    std::reverse(out.begin(), out.end());
+    return forward_.distance(target);
+}
+
+/**
+ * @brief Yen's algorithm
+ *
+ * For the newest accepted path P and each position i, the root is
+ * P[0..i] and the spur node is P[i]. Root nodes before the spur are
+ * blocked (paths stay loopless), as is the next hop of every accepted path
+ * sharing this root (so the spur path differs). root + spur path becomes
+ * a candidate; the shortest candidate is accepted next.
+ */
+std::vector<KShortestPaths::Route> KShortestPaths::yen(uint32_t source, uint32_t target, size_t k) {
+    std::vector<Route> accepted;
+    if (k == 0) {
+        return accepted;
+    }
+    buildTree(target);
+    if (!tree_.reached(source)) {
+        return accepted;
+    }
+
+    Route first;
+    for (uint32_t v = source; v != SearchWorkspace::NO_NODE; v = tree_.previous(v)) {
+        first.nodes.push_back(v);
+    }
+    first.distance = tree_.distance(source);
+    accepted.push_back(first);
+
+    std::vector<Route> candidates;
+    std::set<std::vector<uint32_t>> seen;
+    seen.insert(first.nodes);
+
+    std::vector<uint32_t> blockedNodes;
+    std::vector<uint32_t> blockedNext;
+    std::vector<uint32_t> spur;
+    while (accepted.size() < k) {
+        const Route previous = accepted.back();
+        double rootDistance = 0.0;
+        for (size_t i = 0; i + 1 < previous.nodes.size(); ++i) {
+            uint32_t spurNode = previous.nodes[i];
+
+            blockedNodes.assign(previous.nodes.begin(), previous.nodes.begin() + i);
+            blockedNext.clear();
+            for (const Route& route : accepted) {
+                if (route.nodes.size() > i + 1 &&
+                    std::equal(previous.nodes.begin(), previous.nodes.begin() + i + 1,
+                               route.nodes.begin())) {
+                    blockedNext.push_back(route.nodes[i + 1]);
+                }
+            }
+
+            double spurDistance = spurPath(spurNode, target, blockedNodes, blockedNext, spur);
+            if (spurDistance != INF) {
+                Route candidate;
+                candidate.nodes.assign(previous.nodes.begin(), previous.nodes.begin() + i);
+                candidate.nodes.insert(candidate.nodes.end(), spur.begin(), spur.end());
+                candidate.distance = rootDistance + spurDistance;
+                if (seen.insert(candidate.nodes).second) {
+                    candidates.push_back(candidate);
+                }
+            }
+            rootDistance += edgeWeight(spurNode, previous.nodes[i + 1]);
+        }
+
+        if (candidates.empty()) {
+            break;
+        }
+        std::vector<Route>::iterator best =
+            std::min_element(candidates.begin(), candidates.end(), shorter);
+        accepted.push_back(*best);
+        candidates.erase(best);
+    }
+    return accepted;
+}
+
+/**
+ * @brief Penalty method
+ *
+ * Each round runs Dijkstra on penalised weights, records the path with its
+ * true length, then multiplies the weight of every edge on it (both
+ * directions) by 1 + penalty. Duplicates are skipped.
+ */
+std::vector<KShortestPaths::Route> KShortestPaths::penalty(uint32_t source, uint32_t target,
+                                                           size_t k, double penalty) {
+    std::vector<Route> routes;
+    std::vector<double> factor(graph_.getEdgeCount(), 1.0);
+    std::set<std::vector<uint32_t>> seen;
+
+    for (size_t attempt = 0; attempt < k * PENALTY_ATTEMPTS_PER_ROUTE && routes.size() < k; ++attempt) {
+        forward_.begin(graph_.getNodeCount());
+        forward_.setDistance(source, 0.0, SearchWorkspace::NO_NODE);
+        forward_.push(0.0, source);
+        while (!forward_.empty()) {
+            SearchWorkspace::QueueEntry top = forward_.pop();
+            uint32_t current = top.second;
+            if (forward_.isSettled(current)) {
+                continue;
+            }
+            forward_.settle(current);
+            if (current == target) {
+                break;
+            }
+            uint32_t id = graph_.edgeBegin(current);
+            for (const CSREdge& edge : graph_.neighbors(current)) {
+                double tentativeDist = top.first + edge.weight * factor[id++];
+                if (forward_.relax(edge.target, tentativeDist, current)) {
+                    forward_.push(tentativeDist, edge.target);
+                }
+            }
+        }
+        accumulate(forward_.getStats());
+        if (!forward_.reached(target)) {
+            break;
+        }
+
+        Route route;
+        for (uint32_t v = target; v != SearchWorkspace::NO_NODE; v = forward_.previous(v)) {
+            route.nodes.push_back(v);
+        }
+        std::reverse(route.nodes.begin(), route.nodes.end());
+        route.distance = 0.0;
+        for (size_t i = 0; i + 1 < route.nodes.size(); ++i) {
+            uint32_t from = route.nodes[i];
+            uint32_t to = route.nodes[i + 1];
+            route.distance += edgeWeight(from, to);
+
+            // Penalise the edge in both directions
+            uint32_t id = graph_.edgeBegin(from);
+            for (const CSREdge& edge : graph_.neighbors(from)) {
+                if (edge.target == to) factor[id] *= 1.0 + penalty;
+                ++id;
+            }
+            id = graph_.edgeBegin(to);
+            for (const CSREdge& edge : graph_.neighbors(to)) {
+                if (edge.target == from) factor[id] *= 1.0 + penalty;
+                ++id;
+            }
+        }
+        if (seen.insert(route.nodes).second) {
+            routes.push_back(route);
+        }
+    }
+
+    std::stable_sort(routes.begin(), routes.end(), shorter);
+    return routes;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file KShortestPaths.h
+ * @brief Alternative routes: Yen's k shortest simple paths and the penalty method.
+ *
+ * Yen's algorithm derives every new candidate from an earlier path by
+ * keeping a root prefix and searching a "spur" path from the last root node
+ * with some nodes and edges blocked. Instead of a full Dijkstra per spur,
+ * one backward shortest-path tree to the target is built up front and
+ * reused: when the tree path from the spur node avoids everything blocked
+ * it is taken directly, otherwise an A* search runs with the tree distances
+ * as an exact, consistent heuristic and settles only a handful of nodes.
+ *
+ * The penalty method is cheaper and meant for interactive use: it repeats a
+ * plain Dijkstra, multiplying the weight of every edge used by an earlier
+ * result, so later searches drift onto different streets. Its results are
+ * good alternatives but not guaranteed to be the k shortest.
+ */
+
+#ifndef K_SHORTEST_PATHS_H
+#define K_SHORTEST_PATHS_H
+
+#include "Location.h"
+#include "CSRGraph.h"
+#include "SearchWorkspace.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class KShortestPaths
+ * @brief Index-based alternative route search over a frozen CSRGraph
+ *
+ * Example usage:
+ * @code
+ * KShortestPaths search(csr, forward, backward);
+ * std::vector<KShortestPaths::Route> routes = search.yen(s, t, 3);
+ * @endcode
+ */
+class KShortestPaths {
+public:
+    /**
+     * @struct Route
+     * @brief Node sequence and its length
+     */
+    struct Route {
+        std::vector<uint32_t> nodes;    ///< Dense indices from source to target
+        double distance;                ///< Sum of edge weights
+    };
+
+    /// Weight multiplier added per reuse in the penalty method (1.0 + factor)
+    static constexpr double DEFAULT_PENALTY = 0.5;
+
+private:
+    const CSRGraph<Location*>& graph_;  ///< Routing graph
+    SearchWorkspace& forward_;          ///< Spur / penalty searches
+    SearchWorkspace& tree_;             ///< Backward shortest-path tree to the target
+    SearchStats stats_;                 ///< Counters summed over all searches
+
+    /**
+     * @brief Shortest edge weight from -> to (infinity if none)
+     */
+    double edgeWeight(uint32_t from, uint32_t to) const;
+
+    /**
+     * @brief Grow the backward tree from target over incoming edges
+     */
+    void buildTree(uint32_t target);
+
+    /**
+     * @brief Shortest spur path avoiding blocked nodes and edges
+     * @param spur Spur node
+     * @param target Target node
+     * @param blockedNodes Nodes that must not be visited (root path)
+     * @param blockedNext Forbidden first hops out of spur
+     * @param out Output: spur .. target
+     * @return Spur path length, or infinity if none
+     */
+    double spurPath(uint32_t spur, uint32_t target,
+                    const std::vector<uint32_t>& blockedNodes,
+                    const std::vector<uint32_t>& blockedNext,
+                    std::vector<uint32_t>& out);
+
+    /**
+     * @brief Add a search's counters to stats_
+     */
+    void accumulate(const SearchStats& stats);
+
+public:
+    /**
+     * @brief Constructor
+     * @param graph Routing graph
+     * @param forward Workspace for forward searches
+     * @param tree Workspace holding the backward tree (Yen only)
+     */
+    KShortestPaths(const CSRGraph<Location*>& graph,
+                   SearchWorkspace& forward, SearchWorkspace& tree);
+
+    /**
+     * @brief Yen's k shortest loopless paths
+     * @param source Dense start index
+     * @param target Dense end index
+     * @param k Maximum number of routes
+     * @return Up to k routes in ascending length (empty if unreachable)
+     */
+    std::vector<Route> yen(uint32_t source, uint32_t target, size_t k);
+
+    /**
+     * @brief Penalty method alternatives
+     * @param source Dense start index
+     * @param target Dense end index
+     * @param k Maximum number of routes
+     * @param penalty Each reuse multiplies an edge's weight by (1 + penalty)
+     * @return Up to k distinct routes with their true lengths, ascending
+     */
+    std::vector<Route> penalty(uint32_t source, uint32_t target, size_t k,
+                               double penalty = DEFAULT_PENALTY);
+
+    /**
+     * @brief Counters summed over every search run so far
+     */
+    const SearchStats& getStats() const;
+};
+
+#endif // K_SHORTEST_PATHS_H
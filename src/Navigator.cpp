@@ -12,18 +12,31 @@
  * Contains Dijkstra-based path computations and helpers to work with vias.
  */
 #include "WalkingMode.h"
+#include "CyclingMode.h"
 #include <queue>
 #include <limits>
 #include <algorithm>
 #include <iostream>
+#include <cmath>
 
 // Constants
 const double INF = std::numeric_limits<double>::infinity();
+const uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+
+// Dial's circular bucket array is capped at this many buckets
+const size_t MAX_DIAL_BUCKETS = static_cast<size_t>(1) << 22;
 
 // Constructor
-Navigator::Navigator() {
+Navigator::Navigator()
+    : engine_(SearchEngine::Dijkstra), queuePolicy_(QueuePolicy::BinaryHeap), heuristicScale_(1.0),
+      maxEdgeWeight_(0.0), quantizationStep_(1.0), precomputeAllPairs_(false),
+      chReady_(false), tableReady_(false), threadCount_(0), routeCache_(new RouteCache()),
+      optimizeViaOrder_(false) {
     // Set default navigation mode to walking
     currentMode_ = std::make_shared<WalkingMode>();
+    
+    // Connection edits and closures check edges on hub nodes
+    graph_.setEdgeIndexEnabled(true);
 }
 
 // Destructor
@@ -52,6 +65,155 @@ void Navigator::initializeGraph(const std::vector<Location*>& locations,
         // Add bidirectional edge
         graph_.addUndirectedEdge(locations[from], locations[to], dist);
     }
+    
+    rebuildRoutingGraph();
+}
+
+// Rebuild routing structures after graph_ changed
+void Navigator::rebuildRoutingGraph() {
+    // Freeze the adjacency into CSR form for routing
+    csr_ = CSRGraph<Location*>(graph_, allLocations_);
+    resetDerivedData();
+    
+    // A* uses the great-circle distance as a lower bound. Edge weights come
+    // from CampusData and may be shorter than the straight line, so scale
+    // the heuristic down by the worst ratio to keep it admissible.
+    heuristicScale_ = 1.0;
+    maxEdgeWeight_ = 0.0;
+    for (uint32_t u = 0; u < csr_.getNodeCount(); ++u) {
+        for (const CSREdge& edge : csr_.neighbors(u)) {
+            maxEdgeWeight_ = std::max(maxEdgeWeight_, edge.weight);
+            double straight = csr_.nodeAt(u)->distanceTo(*csr_.nodeAt(edge.target));
+            if (straight > 0.0 && edge.weight < straight * heuristicScale_) {
+                heuristicScale_ = std::max(0.0, edge.weight / straight);
+            }
+        }
+    }
+    
+    // Closures outlive edits as long as their connection still exists
+    for (auto it = closedEdges_.begin(); it != closedEdges_.end(); ) {
+        if (graph_.hasEdge(it->first, it->second)) {
+            setEdgeClosed(indexOf(it->first), indexOf(it->second), true);
+            ++it;
+        } else {
+            it = closedEdges_.erase(it);
+        }
+    }
+    
+    if (precomputeAllPairs_) {
+        buildAllPairsTable();
+    }
+}
+
+// Forget everything derived from the previous csr_
+void Navigator::resetDerivedData() {
+    ch_ = ContractionHierarchy();
+    allPairs_ = AllPairsTable();
+    chReady_ = false;
+    tableReady_ = false;
+    
+    // Location ids are normally 0..N-1, so a flat table translates
+    // Location* to its dense index without a tree lookup
+    idToIndex_.clear();
+    for (uint32_t i = 0; i < csr_.getNodeCount(); ++i) {
+        int id = csr_.nodeAt(i)->getId();
+        if (id < 0 || static_cast<size_t>(id) > 4 * csr_.getNodeCount()) {
+            continue;   // sparse/odd ids fall back to the CSR map lookup
+        }
+        if (idToIndex_.size() <= static_cast<size_t>(id)) {
+            idToIndex_.resize(id + 1, NO_NODE);
+        }
+        idToIndex_[id] = i;
+    }
+}
+
+// Write csr_ (with closures lifted) to a snapshot file
+void Navigator::saveSnapshot(const std::string& path) const {
+    if (closedEdges_.empty()) {
+        GraphSnapshot::write(path, csr_, maxEdgeWeight_, heuristicScale_);
+    } else {
+        // graph_ is materialized whenever a closure exists
+        GraphSnapshot::write(path, CSRGraph<Location*>(graph_, allLocations_),
+                             maxEdgeWeight_, heuristicScale_);
+    }
+}
+
+// Serve routing from a mapped snapshot
+void Navigator::loadSnapshot(const std::string& path, bool verifyChecksum) {
+    std::shared_ptr<const GraphSnapshot> snapshot = GraphSnapshot::open(path, verifyChecksum);
+    
+    std::vector<std::unique_ptr<Location>> owned;
+    std::vector<Location*> nodes;
+    owned.reserve(snapshot->getNodeCount());
+    nodes.reserve(snapshot->getNodeCount());
+    for (uint32_t i = 0; i < snapshot->getNodeCount(); ++i) {
+        const SnapshotNode& node = snapshot->node(i);
+        owned.emplace_back(new Location(snapshot->name(i), node.latitude, node.longitude,
+                                        snapshot->description(i), node.id));
+        nodes.push_back(owned.back().get());
+    }
+    
+    graph_.clear();     // bumps the version, so cached routes expire
+    closedEdges_.clear();
+    csr_ = CSRGraph<Location*>(nodes, snapshot->getArrays(), snapshot);
+    allLocations_ = nodes;
+    ownedLocations_.swap(owned);
+    maxEdgeWeight_ = snapshot->getMaxEdgeWeight();
+    heuristicScale_ = snapshot->getHeuristicScale();
+    resetDerivedData();
+    
+    if (precomputeAllPairs_) {
+        buildAllPairsTable();
+    }
+}
+
+// Fill graph_ from a snapshot-backed csr_
+void Navigator::materializeGraph() {
+    if (graph_.getNodeCount() > 0 || !csr_.isExternal()) {
+        return;
+    }
+    for (uint32_t u = 0; u < csr_.getNodeCount(); ++u) {
+        graph_.addNode(csr_.nodeAt(u));
+    }
+    for (uint32_t u = 0; u < csr_.getNodeCount(); ++u) {
+        for (const CSREdge& edge : csr_.neighbors(u)) {
+            graph_.addEdge(csr_.nodeAt(u), csr_.nodeAt(edge.target), edge.weight);
+        }
+    }
+}
+
+// Close or restore the CSR copies of from -> to
+double Navigator::setEdgeClosed(uint32_t from, uint32_t to, bool closed) {
+    // csr_ lists a node's edges in graph_ order, so the k-th neighbour
+    // is edge edgeBegin(from) + k
+    Location* head = csr_.nodeAt(to);
+    double restored = INF;
+    uint32_t id = csr_.edgeBegin(from);
+    for (const Edge<Location*>& edge : graph_.neighbors(csr_.nodeAt(from))) {
+        if (edge.destination == head) {
+            csr_.setEdgeWeight(id, closed ? INF : edge.weight);
+            if (!closed) {
+                restored = std::min(restored, edge.weight);
+            }
+        }
+        ++id;
+    }
+    return restored;
+}
+
+// Translate a location to its dense index
+uint32_t Navigator::indexOf(Location* loc) const {
+    int id = loc->getId();
+    if (id >= 0 && static_cast<size_t>(id) < idToIndex_.size()) {
+        uint32_t index = idToIndex_[id];
+        if (index != NO_NODE && csr_.nodeAt(index) == loc) {
+            return index;
+        }
+    }
+    if (!csr_.hasNode(loc)) {
+        throw InvalidLocationException("Location not found in graph");
+    }
+    return csr_.indexOf(loc);
 }
 
 // Find path by name
@@ -69,26 +231,132 @@ Path Navigator::findPath(const std::string& startName, const std::string& endNam
 
 // Find path by pointers
 Path Navigator::findPath(Location* start, Location* end) {
+    return findPath(start, end, engine_);
+}
+
+// Find path by pointers with an explicit engine
+Path Navigator::findPath(Location* start, Location* end, SearchEngine engine) {
+    // Stateful wrapper over the const query API
+    RouteResult result = route(start, end, std::vector<Location*>(), engine);
+    lastViaOrder_.clear();
+    lastPath_ = result.path;
+    lastStats_ = result.stats;
+    return lastPath_;
+}
+
+// Const route query using the default engine
+RouteResult Navigator::route(Location* start, Location* end,
+                             const std::vector<Location*>& vias) const {
+    return route(start, end, vias, engine_);
+}
+
+// Const route query
+RouteResult Navigator::route(Location* start, Location* end,
+                             const std::vector<Location*>& vias, SearchEngine engine) const {
     // EXCEPTION HANDLING: Validate inputs
     if (start == nullptr || end == nullptr) {
         throw InvalidLocationException("Start or end location is null");
     }
     
-    if (!graph_.hasNode(start) || !graph_.hasNode(end)) {
-        throw InvalidLocationException("Location not found in graph");
+    // Check that vias don't include start or end
+    RouteKey key;
+    key.start = start->getId();
+    key.end = end->getId();
+    key.engine = static_cast<int>(engine);
+    for (Location* v : vias) {
+        if (v == nullptr) continue;
+        if (v->getId() == start->getId() || v->getId() == end->getId()) {
+            throw ViaSelectionException("Via location cannot be the same as start or end");
+        }
+        if (!csr_.hasNode(v)) {
+            throw InvalidLocationException("Via location not found in graph: " + v->getName());
+        }
+        key.vias.push_back(v->getId());
     }
     
-    // Use Dijkstra's algorithm (ABSTRACTION: hidden from public interface)
-    lastPath_ = dijkstraShortestPath(start, end);
+    std::shared_ptr<NavigationMode> mode = currentMode_;
+    if (mode != nullptr) {
+        key.mode = mode->getModeName();
+    }
     
-    return lastPath_;
+    // Repeated query: served from the cache unless the graph changed since
+    const unsigned long long version = graph_.getVersion();
+    std::shared_ptr<const RouteResult> cached = routeCache_->find(key, version);
+    if (cached) {
+        return *cached;
+    }
+    
+    // Route start -> via1 -> via2 -> ... -> end, one search per leg
+    RouteResult result;
+    Location* legStart = start;
+    for (size_t i = 0; i <= vias.size(); ++i) {
+        Location* legEnd = (i < vias.size()) ? vias[i] : end;
+        if (legEnd == nullptr) continue;
+        
+        SearchStats legStats;
+        Path leg = shortestLeg(legStart, legEnd, engine, legStats);
+        result.path = result.path.empty() ? leg : result.path + leg;
+        result.stats.nodesSettled += legStats.nodesSettled;
+        result.stats.edgesRelaxed += legStats.edgesRelaxed;
+        result.stats.allocations += legStats.allocations;
+        
+        legStart = legEnd;
+    }
+    
+    // ETA for the configured mode and for every built-in mode
+    static const WalkingMode walking;
+    static const CyclingMode cycling;
+    result.distanceMeters = result.path.getTotalDistance();
+    result.walkingMinutes = walking.calculateTime(result.distanceMeters);
+    result.cyclingMinutes = cycling.calculateTime(result.distanceMeters);
+    if (mode != nullptr) {
+        result.modeName = mode->getModeName();
+        result.estimatedMinutes = mode->calculateTime(result.distanceMeters);
+    }
+    
+    if (routeCache_->enabled()) {
+        routeCache_->insert(key, version, std::make_shared<const RouteResult>(result));
+    }
+    return result;
+}
+
+// Run a single leg on the requested engine
+Path Navigator::shortestLeg(Location* start, Location* end, SearchEngine engine,
+                            SearchStats& stats) const {
+    if (!csr_.hasNode(start) || !csr_.hasNode(end)) {
+        throw InvalidLocationException("Location not found in graph");
+    }
+    
+    // Search engines are hidden from the public interface (ABSTRACTION)
+    switch (engine) {
+    case SearchEngine::AStar:
+        return aStarShortestPath(start, end, stats);
+    case SearchEngine::Bidirectional:
+        return bidirectionalShortestPath(start, end, stats);
+    case SearchEngine::ContractionHierarchies:
+        return hierarchyShortestPath(start, end, stats);
+    case SearchEngine::AllPairsTable:
+        return tableShortestPath(start, end, stats);
+    case SearchEngine::Dial:
+        return dialShortestPath(start, end, stats);
+    case SearchEngine::Dijkstra:
+    default:
+        return dijkstraShortestPath(start, end, stats);
+    }
 }
 
 /**
  * @brief Dijkstra's Algorithm Implementation
  * 
- * Time Complexity: O((V + E) log V) using priority queue
- * Space Complexity: O(V)
+ * Time Complexity: O((V' + E') log V') for the V' nodes actually reached
+ * Space Complexity: O(V), allocated once per thread
+ * 
+ * All search state is kept in the thread's SearchWorkspace, indexed by
+ * the dense node index and reset lazily by epoch; Location pointers are
+ * only translated at entry and in reconstructPath.
+ * 
+ * The priority queue is a policy chosen with setQueuePolicy(); every
+ * policy settles nodes in the same order up to ties.
  * 
  * Algorithm Steps:
  * 1. Initialize all distances to infinity except source (0)
@@ -97,67 +365,73 @@ Path Navigator::findPath(Location* start, Location* end) {
  * 4. Update if shorter path found
  * 5. Reconstruct path by backtracking
  */
-Path Navigator::dijkstraShortestPath(Location* start, Location* end) {
-    // Data structures for Dijkstra
-    std::map<Location*, double> distances;
-    std::map<Location*, Location*> previous;
-    std::map<Location*, bool> visited;
-    
-    // Priority queue: pair<distance, location>
-    // Min-heap based on distance
-    std::priority_queue<std::pair<double, Location*>,
-                        std::vector<std::pair<double, Location*>>,
-                        std::greater<std::pair<double, Location*>>> pq;
-    
-    // Step 1: Initialize distances
-    for (Location* loc : allLocations_) {
-        distances[loc] = INF;
-        visited[loc] = false;
+Path Navigator::dijkstraShortestPath(Location* start, Location* end,
+                                SearchStats& stats) const {
+    switch (queuePolicy_) {
+    case QueuePolicy::QuaternaryHeap:
+        return dijkstraWithQueue<QuaternaryHeapQueue>(start, end, stats);
+    case QueuePolicy::PairingHeap:
+        return dijkstraWithQueue<PairingHeapQueue>(start, end, stats);
+    case QueuePolicy::RadixHeap:
+        return dijkstraWithQueue<RadixHeapQueue>(start, end, stats);
+    case QueuePolicy::BinaryHeap:
+    default:
+        return dijkstraWithQueue<BinaryHeapQueue>(start, end, stats);
     }
-    distances[start] = 0.0;
+}
+
+// Dijkstra's main loop, instantiated once per queue policy
+template<typename Queue>
+Path Navigator::dijkstraWithQueue(Location* start, Location* end,
+                                  SearchStats& stats) const {
+    const uint32_t source = indexOf(start);
+    const uint32_t target = indexOf(end);
     
-    // Step 2: Add start node to priority queue
-    pq.push({0.0, start});
+    // Per-thread workspace: state is invalidated by epoch, not cleared
+    SearchWorkspace& ws = threadWorkspace();
+    ws.begin(csr_.getNodeCount());
+    static thread_local Queue queue;
+    queue.clear(csr_.getNodeCount());
+    const size_t queueCapacity = queue.capacity();
+    
+    // Step 1 & 2: Source distance and queue
+    ws.setDistance(source, 0.0, SearchWorkspace::NO_NODE);
+    queue.push(0.0, source);
     
     // Step 3: Main Dijkstra loop
-    while (!pq.empty()) {
+    while (!queue.empty()) {
         // Get node with minimum distance
-        Location* current = pq.top().second;
-        double currentDist = pq.top().first;
-        pq.pop();
+        typename Queue::Entry top = queue.pop();
+        uint32_t current = top.second;
+        double currentDist = top.first;
         
-        // Skip if already visited
-        if (visited[current]) {
+        // Skip if already visited (stale entry of a lazy-deletion queue)
+        if (ws.isSettled(current)) {
             continue;
         }
-        visited[current] = true;
+        ws.settle(current);
         
         // Early termination if destination reached
-        if (current == end) {
+        if (current == target) {
             break;
         }
         
-        // Check all neighbors
-        std::vector<Edge<Location*>> neighbors = graph_.getNeighbors(current);
-        
-        for (const Edge<Location*>& edge : neighbors) {
-            Location* neighbor = edge.destination;
-            double edgeWeight = edge.weight;
-            
-            // Calculate tentative distance
-            double tentativeDist = currentDist + edgeWeight;
-            
+        // Check all neighbors (contiguous CSR scan, no copy)
+        for (const CSREdge& edge : csr_.neighbors(current)) {
             // Update if shorter path found
-            if (tentativeDist < distances[neighbor]) {
-                distances[neighbor] = tentativeDist;
-                previous[neighbor] = current;
-                pq.push({tentativeDist, neighbor});
+            if (ws.relax(edge.target, currentDist + edge.weight, current)) {
+                queue.push(currentDist + edge.weight, edge.target);
             }
         }
     }
+    // The queue lives beside the workspace; its growth counts all the same
+    if (queue.capacity() != queueCapacity) {
+        ws.countAllocation();
+    }
+    stats = ws.getStats();
     
     // Step 4: Check if path exists
-    if (distances[end] == INF) {
+    if (!ws.reached(target)) {
         throw PathNotFoundException(
             "No path exists between " + start->getName() + 
             " and " + end->getName()
@@ -165,28 +439,320 @@ Path Navigator::dijkstraShortestPath(Location* start, Location* end) {
     }
     
     // Step 5: Reconstruct path
-    return reconstructPath(start, end, previous, distances);
+    return reconstructPath(source, target, ws);
+}
+
+/**
+ * @brief A* Search Implementation
+ * 
+ * Same as Dijkstra, but the queue is ordered by g(v) + h(v) where h(v) is
+ * the (scaled) great-circle distance from v to the destination. Haversine
+ * distance obeys the triangle inequality, so h is consistent and each node
+ * is still settled at most once with its exact distance. Nodes leading
+ * away from the destination are never expanded on long routes.
+ */
+Path Navigator::aStarShortestPath(Location* start, Location* end,
+                                SearchStats& stats) const {
+    const uint32_t source = indexOf(start);
+    const uint32_t target = indexOf(end);
+    
+    SearchWorkspace& ws = threadWorkspace();
+    ws.begin(csr_.getNodeCount());
+    
+    ws.setDistance(source, 0.0, SearchWorkspace::NO_NODE);
+    ws.push(heuristicScale_ * start->distanceTo(*end), source);
+    
+    while (!ws.empty()) {
+        uint32_t current = ws.pop().second;
+        if (ws.isSettled(current)) {
+            continue;
+        }
+        ws.settle(current);
+        if (current == target) {
+            break;
+        }
+        
+        double currentDist = ws.distance(current);
+        for (const CSREdge& edge : csr_.neighbors(current)) {
+            double tentativeDist = currentDist + edge.weight;
+            if (ws.relax(edge.target, tentativeDist, current)) {
+                double h = heuristicScale_ * csr_.nodeAt(edge.target)->distanceTo(*end);
+                ws.push(tentativeDist + h, edge.target);
+            }
+        }
+    }
+    stats = ws.getStats();
+    
+    if (!ws.reached(target)) {
+        throw PathNotFoundException(
+            "No path exists between " + start->getName() + 
+            " and " + end->getName()
+        );
+    }
+    
+    return reconstructPath(source, target, ws);
+}
+
+/**
+ * @brief Bidirectional Dijkstra Implementation
+ * 
+ * Grows a forward ball from start over outgoing edges and a backward ball
+ * from end over incoming edges, always advancing the side with the smaller
+ * queue key. mu is the best start->end distance seen through any node
+ * reached by both sides. Once topForward + topBackward >= mu no unsettled
+ * node can yield a shorter path, so the search stops. The path is the
+ * forward predecessor chain to the meeting node followed by the backward
+ * chain from it.
+ */
+Path Navigator::bidirectionalShortestPath(Location* start, Location* end,
+                                SearchStats& stats) const {
+    const uint32_t source = indexOf(start);
+    const uint32_t target = indexOf(end);
+    
+    SearchWorkspace& fwd = threadWorkspace(0);
+    SearchWorkspace& bwd = threadWorkspace(1);
+    fwd.begin(csr_.getNodeCount());
+    bwd.begin(csr_.getNodeCount());
+    
+    fwd.setDistance(source, 0.0, SearchWorkspace::NO_NODE);
+    fwd.push(0.0, source);
+    bwd.setDistance(target, 0.0, SearchWorkspace::NO_NODE);
+    bwd.push(0.0, target);
+    
+    double best = (source == target) ? 0.0 : INF;
+    uint32_t meet = (source == target) ? source : NO_NODE;
+    
+    while (!fwd.empty() && !bwd.empty()) {
+        if (fwd.top().first + bwd.top().first >= best) {
+            break;
+        }
+        
+        // Advance the side whose frontier is closer
+        bool forward = fwd.top().first <= bwd.top().first;
+        SearchWorkspace& self = forward ? fwd : bwd;
+        SearchWorkspace& other = forward ? bwd : fwd;
+        
+        SearchWorkspace::QueueEntry top = self.pop();
+        uint32_t current = top.second;
+        if (self.isSettled(current)) {
+            continue;
+        }
+        self.settle(current);
+        
+        CSRGraph<Location*>::NeighborRange edges =
+            forward ? csr_.neighbors(current) : csr_.incoming(current);
+        for (const CSREdge& edge : edges) {
+            double tentativeDist = top.first + edge.weight;
+            if (self.relax(edge.target, tentativeDist, current)) {
+                self.push(tentativeDist, edge.target);
+            }
+            if (other.reached(edge.target)) {
+                double through = self.distance(edge.target) + other.distance(edge.target);
+                if (through < best) {
+                    best = through;
+                    meet = edge.target;
+                }
+            }
+        }
+    }
+    
+    stats = fwd.getStats();
+    stats.nodesSettled += bwd.getStats().nodesSettled;
+    stats.edgesRelaxed += bwd.getStats().edgesRelaxed;
+    stats.allocations += bwd.getStats().allocations;
+    
+    if (meet == NO_NODE) {
+        throw PathNotFoundException(
+            "No path exists between " + start->getName() + 
+            " and " + end->getName()
+        );
+    }
+    
+    // Splice: start -> ... -> meet (forward chain, reversed) + meet -> ... -> end
+    std::vector<Location*> nodes;
+    for (uint32_t v = meet; v != NO_NODE; v = fwd.previous(v)) {
+        nodes.push_back(csr_.nodeAt(v));
+    }
+    std::reverse(nodes.begin(), nodes.end());
+    for (uint32_t v = bwd.previous(meet); v != NO_NODE; v = bwd.previous(v)) {
+        nodes.push_back(csr_.nodeAt(v));
+    }
+    
+    Path path(nodes.front());
+    for (size_t i = 1; i < nodes.size(); ++i) {
+        path.addLocation(nodes[i]);
+    }
+    path.setTotalDistance(best);
+    return path;
+}
+
+// Contraction Hierarchies query
+Path Navigator::hierarchyShortestPath(Location* start, Location* end,
+                                SearchStats& stats) const {
+    const uint32_t source = indexOf(start);
+    const uint32_t target = indexOf(end);
+    ensureHierarchy();
+    
+    std::vector<uint32_t> nodes;
+    double distance = ch_.query(source, target, nodes,
+                                threadWorkspace(0), threadWorkspace(1), stats);
+    if (distance == INF) {
+        throw PathNotFoundException(
+            "No path exists between " + start->getName() + 
+            " and " + end->getName()
+        );
+    }
+    
+    // Shortcuts are already unpacked, so nodes are real campus locations
+    Path path(csr_.nodeAt(nodes.front()));
+    for (size_t i = 1; i < nodes.size(); ++i) {
+        path.addLocation(csr_.nodeAt(nodes[i]));
+    }
+    path.setTotalDistance(distance);
+    return path;
+}
+
+// All-pairs table walk
+Path Navigator::tableShortestPath(Location* start, Location* end,
+                                SearchStats& stats) const {
+    const uint32_t source = indexOf(start);
+    const uint32_t target = indexOf(end);
+    ensureAllPairsTable();
+    
+    stats = SearchStats();
+    std::vector<uint32_t> nodes;
+    if (!allPairs_.walk(source, target, nodes)) {
+        throw PathNotFoundException(
+            "No path exists between " + start->getName() + 
+            " and " + end->getName()
+        );
+    }
+    
+    Path path(csr_.nodeAt(nodes.front()));
+    for (size_t i = 1; i < nodes.size(); ++i) {
+        path.addLocation(csr_.nodeAt(nodes[i]));
+    }
+    path.setTotalDistance(allPairs_.distance(source, target));
+    return path;
+}
+
+/**
+ * @brief Dial's algorithm (bucket-queue Dijkstra)
+ * 
+ * Weights become integers q = round(w / step). Tentative distances then
+ * lie in [d, d + C] for the current distance d and C = max q, so a
+ * circular array of C + 1 buckets replaces the heap: bucket d mod (C + 1)
+ * holds the nodes at distance d, and the scan only moves forward.
+ * O(V + E + D) for a search that ends at distance D. Entries whose
+ * distance has since improved are skipped when their bucket is reached.
+ */
+Path Navigator::dialShortestPath(Location* start, Location* end,
+                                 SearchStats& stats) const {
+    const uint32_t source = indexOf(start);
+    const uint32_t target = indexOf(end);
+    const double step = quantizationStep_;
+    
+    const size_t bucketCount = static_cast<size_t>(std::ceil(maxEdgeWeight_ / step + 0.5)) + 1;
+    if (bucketCount > MAX_DIAL_BUCKETS) {
+        throw std::runtime_error("Quantization step too small for Dial's bucket queue");
+    }
+    static thread_local std::vector<std::vector<uint32_t>> buckets;
+    bool bucketsGrew = false;
+    if (buckets.size() < bucketCount) {
+        buckets.resize(bucketCount);
+        bucketsGrew = true;
+    }
+    size_t bucketCapacity = 0;
+    for (size_t i = 0; i < bucketCount; ++i) {
+        buckets[i].clear();     // leftovers of an early-terminated search
+        bucketCapacity += buckets[i].capacity();
+    }
+    
+    SearchWorkspace& ws = threadWorkspace();
+    ws.begin(csr_.getNodeCount());
+    ws.setDistance(source, 0.0, SearchWorkspace::NO_NODE);
+    buckets[0].push_back(source);
+    size_t pending = 1;
+    
+    // Distances are whole steps, stored exactly in the workspace's doubles
+    bool found = false;
+    for (uint64_t current = 0; pending > 0 && !found; ++current) {
+        std::vector<uint32_t>& bucket = buckets[current % bucketCount];
+        while (!bucket.empty()) {
+            uint32_t node = bucket.back();
+            bucket.pop_back();
+            --pending;
+            if (ws.isSettled(node) || ws.distance(node) != static_cast<double>(current)) {
+                continue;   // stale entry
+            }
+            ws.settle(node);
+            if (node == target) {
+                found = true;
+                break;
+            }
+            for (const CSREdge& edge : csr_.neighbors(node)) {
+                if (edge.weight == INF) {
+                    continue;   // closed connection
+                }
+                uint64_t next = current + static_cast<uint64_t>(std::llround(edge.weight / step));
+                if (ws.relax(edge.target, static_cast<double>(next), node)) {
+                    buckets[next % bucketCount].push_back(edge.target);
+                    ++pending;
+                }
+            }
+        }
+    }
+    // Buckets live beside the workspace; their growth counts all the same
+    size_t bucketCapacityAfter = 0;
+    for (size_t i = 0; i < bucketCount; ++i) {
+        bucketCapacityAfter += buckets[i].capacity();
+    }
+    if (bucketsGrew || bucketCapacityAfter != bucketCapacity) {
+        ws.countAllocation();
+    }
+    stats = ws.getStats();
+    
+    if (!ws.reached(target)) {
+        throw PathNotFoundException(
+            "No path exists between " + start->getName() + 
+            " and " + end->getName()
+        );
+    }
+    
+    // Report the true length of the chosen path, not the rounded one
+    Path path = reconstructPath(source, target, ws);
+    double length = 0.0;
+    for (uint32_t v = target; v != source; v = ws.previous(v)) {
+        uint32_t u = ws.previous(v);
+        double best = INF;
+        for (const CSREdge& edge : csr_.neighbors(u)) {
+            if (edge.target == v) {
+                best = std::min(best, edge.weight);
+            }
+        }
+        length += best;
+    }
+    path.setTotalDistance(length);
+    return path;
 }
 
 // Reconstruct path from Dijkstra results
-Path Navigator::reconstructPath(Location* start, Location* end,
-                                 const std::map<Location*, Location*>& previous,
-                                 const std::map<Location*, double>& distances) {
+Path Navigator::reconstructPath(uint32_t start, uint32_t end,
+                                 const SearchWorkspace& workspace) const {
     Path path;
     
     // Backtrack from end to start
     std::vector<Location*> reversePath;
-    Location* current = end;
+    uint32_t current = end;
     
     while (current != start) {
-        reversePath.push_back(current);
-        auto it = previous.find(current);
-        if (it == previous.end()) {
+        reversePath.push_back(csr_.nodeAt(current));
+        current = workspace.previous(current);
+        if (current == NO_NODE) {
             throw PathNotFoundException("Path reconstruction failed");
         }
-        current = it->second;
     }
-    reversePath.push_back(start);
+    reversePath.push_back(csr_.nodeAt(start));
     
     // Reverse to get correct order
     std::reverse(reversePath.begin(), reversePath.end());
@@ -201,55 +767,573 @@ Path Navigator::reconstructPath(Location* start, Location* end,
     }
     
     // Set total distance from Dijkstra result
-    path.setTotalDistance(distances.at(end));
+    path.setTotalDistance(workspace.distance(end));
     
     return path;
 }
 
-// Find path passing through vias in order
+// Find path passing through vias (in order, or reordered when optimizing)
 Path Navigator::findPath(Location* start, Location* end, const std::vector<Location*>& vias) {
-    // Validate inputs
+    // Null vias are skipped, as route() does, before they reach the optimizer
+    std::vector<Location*> order;
+    for (Location* via : vias) {
+        if (via != nullptr) {
+            order.push_back(via);
+        }
+    }
+    if (optimizeViaOrder_ && order.size() > 1) {
+        order = optimizeViaOrder(start, end, order);
+    }
+    RouteResult result = route(start, end, order, engine_);
+    lastViaOrder_ = order;
+    lastPath_ = result.path;
+    lastStats_ = result.stats;
+    return lastPath_;
+}
+
+// Dijkstra from one source until every target is settled
+void Navigator::oneToMany(uint32_t source, const std::vector<uint32_t>& targets,
+                          double* row) const {
+    std::vector<uint32_t> pending(targets);
+    std::sort(pending.begin(), pending.end());
+    pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+    size_t remaining = pending.size();
+    
+    SearchWorkspace& ws = threadWorkspace();
+    ws.begin(csr_.getNodeCount());
+    ws.setDistance(source, 0.0, SearchWorkspace::NO_NODE);
+    ws.push(0.0, source);
+    
+    while (!ws.empty() && remaining > 0) {
+        SearchWorkspace::QueueEntry top = ws.pop();
+        uint32_t current = top.second;
+        if (ws.isSettled(current)) {
+            continue;
+        }
+        ws.settle(current);
+        if (std::binary_search(pending.begin(), pending.end(), current)) {
+            --remaining;
+        }
+        for (const CSREdge& edge : csr_.neighbors(current)) {
+            if (ws.relax(edge.target, top.first + edge.weight, current)) {
+                ws.push(top.first + edge.weight, edge.target);
+            }
+        }
+    }
+    
+    for (size_t i = 0; i < targets.size(); ++i) {
+        row[i] = ws.isSettled(targets[i]) ? ws.distance(targets[i]) : INF;
+    }
+}
+
+// Alternative routes
+std::vector<Path> Navigator::findAlternatives(Location* start, Location* end, size_t k,
+                                              AlternativeMethod method) const {
     if (start == nullptr || end == nullptr) {
         throw InvalidLocationException("Start or end location is null");
     }
+    const uint32_t source = indexOf(start);
+    const uint32_t target = indexOf(end);
+    
+    KShortestPaths search(csr_, threadWorkspace(0), threadWorkspace(1));
+    std::vector<KShortestPaths::Route> routes = (method == AlternativeMethod::Penalty)
+        ? search.penalty(source, target, k)
+        : search.yen(source, target, k);
+    if (routes.empty() && k > 0) {
+        throw PathNotFoundException(
+            "No path exists between " + start->getName() + 
+            " and " + end->getName()
+        );
+    }
+    
+    std::vector<Path> paths;
+    for (const KShortestPaths::Route& route : routes) {
+        Path path(csr_.nodeAt(route.nodes.front()));
+        for (size_t i = 1; i < route.nodes.size(); ++i) {
+            path.addLocation(csr_.nodeAt(route.nodes[i]));
+        }
+        path.setTotalDistance(route.distance);
+        paths.push_back(path);
+    }
+    std::stable_sort(paths.begin(), paths.end());
+    return paths;
+}
 
-    // Check that vias don't include start or end
-    for (Location* v : vias) {
-        if (v == nullptr) continue;
-        if (v->getId() == start->getId() || v->getId() == end->getId()) {
-            throw ViaSelectionException("Via location cannot be the same as start or end");
+// Invert a mode's time model
+double Navigator::distanceWithin(const NavigationMode& mode, double minutes) {
+    if (mode.calculateTime(0.0) > minutes) {
+        return -1.0;
+    }
+    
+    // Bracket the answer, starting from the mode's nominal speed
+    double low = 0.0;
+    double high = std::max(1.0, mode.getAverageSpeed() * 1000.0 / 60.0 * minutes);
+    for (int i = 0; i < 64 && mode.calculateTime(high) <= minutes; ++i) {
+        low = high;
+        high *= 2.0;
+    }
+    
+    // calculateTime(low) <= minutes < calculateTime(high)
+    for (int i = 0; i < 64 && high - low > 1e-6; ++i) {
+        double middle = 0.5 * (low + high);
+        if (mode.calculateTime(middle) <= minutes) {
+            low = middle;
+        } else {
+            high = middle;
         }
-        if (!graph_.hasNode(v)) {
-            throw InvalidLocationException("Via location not found in graph: " + v->getName());
+    }
+    return low;
+}
+
+// Isochrone in the current mode
+Isochrone Navigator::reachableWithin(Location* origin, double minutes) const {
+    std::shared_ptr<NavigationMode> mode = currentMode_;
+    if (mode == nullptr) {
+        throw std::runtime_error("Navigation mode not set");
+    }
+    return reachableWithin(origin, minutes, *mode);
+}
+
+// Bounded Dijkstra from origin
+Isochrone Navigator::reachableWithin(Location* origin, double minutes,
+                                     const NavigationMode& mode) const {
+    if (origin == nullptr) {
+        throw InvalidLocationException("Origin location is null");
+    }
+    if (minutes < 0.0) {
+        throw std::invalid_argument("Time budget cannot be negative");
+    }
+    const uint32_t source = indexOf(origin);
+    
+    Isochrone result;
+    result.budgetMinutes = minutes;
+    result.modeName = mode.getModeName();
+    result.distanceLimitMeters = distanceWithin(mode, minutes);
+    if (result.distanceLimitMeters < 0.0) {
+        result.distanceLimitMeters = 0.0;
+        return result;
+    }
+    const double limit = result.distanceLimitMeters;
+    
+    SearchWorkspace& ws = threadWorkspace();
+    ws.begin(csr_.getNodeCount());
+    ws.setDistance(source, 0.0, SearchWorkspace::NO_NODE);
+    ws.push(0.0, source);
+    
+    while (!ws.empty()) {
+        SearchWorkspace::QueueEntry top = ws.pop();
+        uint32_t current = top.second;
+        if (top.first > limit) {
+            break;  // everything left in the queue is further still
+        }
+        if (ws.isSettled(current)) {
+            continue;
+        }
+        ws.settle(current);
+        
+        // Settled in distance order, so results come out sorted by time
+        ReachableLocation reached;
+        reached.location = csr_.nodeAt(current);
+        reached.distanceMeters = top.first;
+        reached.arrivalMinutes = mode.calculateTime(top.first);
+        result.reachable.push_back(reached);
+        
+        for (const CSREdge& edge : csr_.neighbors(current)) {
+            double tentativeDist = top.first + edge.weight;
+            if (tentativeDist <= limit && ws.relax(edge.target, tentativeDist, current)) {
+                ws.push(tentativeDist, edge.target);
+            }
         }
     }
+    return result;
+}
 
-    // If no vias, just call the simple findPath
-    if (vias.empty()) {
-        return findPath(start, end);
+// Many-to-many distances, one search per source
+std::vector<double> Navigator::distanceMatrix(const std::vector<Location*>& sources,
+                                              const std::vector<Location*>& targets) const {
+    // Translate (and validate) on the calling thread so errors surface here
+    std::vector<uint32_t> rows;
+    std::vector<uint32_t> columns;
+    for (Location* loc : sources) {
+        if (loc == nullptr) {
+            throw InvalidLocationException("Source location is null");
+        }
+        rows.push_back(indexOf(loc));
+    }
+    for (Location* loc : targets) {
+        if (loc == nullptr) {
+            throw InvalidLocationException("Target location is null");
+        }
+        columns.push_back(indexOf(loc));
+    }
+    
+    std::vector<double> matrix(rows.size() * columns.size(), INF);
+    if (columns.empty()) {
+        return matrix;
     }
+    workerPool().parallelFor(rows.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            oneToMany(rows[i], columns, &matrix[i * columns.size()]);
+        }
+    });
+    return matrix;
+}
 
-    // Build combined path sequentially: start -> via1 -> via2 -> ... -> end
-    Path combined;
-    Location* currentStart = start;
+// Full single-source distances, parallel Delta-stepping
+std::vector<double> Navigator::distancesFrom(Location* source, double delta) const {
+    if (source == nullptr) {
+        throw InvalidLocationException("Source location is null");
+    }
+    DeltaStepping search(csr_, &workerPool());
+    search.run(indexOf(source), delta);
+    return search.distances();
+}
 
-    for (size_t i = 0; i <= vias.size(); ++i) {
-        Location* currentEnd = (i < vias.size()) ? vias[i] : end;
+// Shortest via visiting order
+std::vector<Location*> Navigator::optimizeViaOrder(Location* start, Location* end,
+                                                   const std::vector<Location*>& vias) const {
+    if (start == nullptr || end == nullptr) {
+        throw InvalidLocationException("Start or end location is null");
+    }
+    if (vias.size() < 2) {
+        return vias;
+    }
+    
+    // Stops: 0 = start, 1..k = vias, k + 1 = end
+    std::vector<Location*> stops;
+    stops.push_back(start);
+    stops.insert(stops.end(), vias.begin(), vias.end());
+    stops.push_back(end);
+    
+    // Nothing leaves end, so its row is never searched and stays infinite
+    std::vector<Location*> sources(stops.begin(), stops.end() - 1);
+    std::vector<double> matrix = distanceMatrix(sources, stops);
+    matrix.resize(stops.size() * stops.size(), INF);
+    
+    std::vector<size_t> order = ViaOrderOptimizer::optimize(matrix, vias.size());
+    std::vector<Location*> reordered;
+    for (size_t index : order) {
+        reordered.push_back(vias[index]);
+    }
+    return reordered;
+}
 
-        Path leg = findPath(currentStart, currentEnd);
+// Enable/disable via reordering
+void Navigator::setOptimizeViaOrder(bool enabled) {
+    optimizeViaOrder_ = enabled;
+}
 
-        if (combined.empty()) {
-            combined = leg;
-        } else {
-            combined = combined + leg;
+// Via reordering enabled?
+bool Navigator::getOptimizeViaOrder() const {
+    return optimizeViaOrder_;
+}
+
+// Via order of the last findPath
+std::vector<Location*> Navigator::getLastViaOrder() const {
+    return lastViaOrder_;
+}
+
+// Batch routing on the worker pool
+std::vector<Path> Navigator::findPaths(const std::vector<std::pair<Location*, Location*>>& pairs) const {
+    std::vector<Path> paths(pairs.size());
+    workerPool().parallelFor(pairs.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            try {
+                paths[i] = route(pairs[i].first, pairs[i].second).path;
+            } catch (const PathNotFoundException&) {
+                // Leave an empty path for unreachable pairs
+            }
         }
+    });
+    return paths;
+}
 
-        currentStart = currentEnd;
+// Add a two-way connection
+void Navigator::addConnection(Location* a, Location* b, double distance) {
+    if (a == nullptr || b == nullptr) {
+        throw InvalidLocationException("Connection endpoint is null");
+    }
+    Location* ends[] = { a, b };
+    for (Location* loc : ends) {
+        if (std::find(allLocations_.begin(), allLocations_.end(), loc) == allLocations_.end()) {
+            allLocations_.push_back(loc);
+        }
     }
+    materializeGraph();
+    graph_.addUndirectedEdge(a, b, distance);
+    rebuildRoutingGraph();
+}
 
-    // Set lastPath_ and return
-    lastPath_ = combined;
-    return lastPath_;
+// Remove a two-way connection
+void Navigator::removeConnection(Location* a, Location* b) {
+    materializeGraph();
+    graph_.removeEdge(a, b);
+    graph_.removeEdge(b, a);
+    rebuildRoutingGraph();
+}
+
+// Remove a location
+void Navigator::removeLocation(Location* loc) {
+    materializeGraph();
+    graph_.removeNode(loc);
+    allLocations_.erase(std::remove(allLocations_.begin(), allLocations_.end(), loc),
+                        allLocations_.end());
+    rebuildRoutingGraph();
+}
+
+// Temporarily close a two-way connection
+ClosureStats Navigator::closeConnection(Location* a, Location* b) {
+    if (a == nullptr || b == nullptr) {
+        throw InvalidLocationException("Connection endpoint is null");
+    }
+    materializeGraph();
+    if (!graph_.hasEdge(a, b) && !graph_.hasEdge(b, a)) {
+        throw InvalidLocationException("No connection between " + a->getName() +
+                                       " and " + b->getName());
+    }
+    
+    ClosureStats stats;
+    std::vector<std::pair<Location*, Location*>> closed;
+    std::pair<Location*, Location*> directions[] = { std::make_pair(a, b), std::make_pair(b, a) };
+    {
+        std::lock_guard<std::mutex> lock(preprocessMutex_);
+        for (const std::pair<Location*, Location*>& edge : directions) {
+            if (!graph_.hasEdge(edge.first, edge.second) || !closedEdges_.insert(edge).second) {
+                continue;
+            }
+            uint32_t from = indexOf(edge.first);
+            uint32_t to = indexOf(edge.second);
+            setEdgeClosed(from, to, true);
+            if (tableReady_) {
+                TableRepairStats repair = allPairs_.edgeClosed(csr_, from, to);
+                stats.table.rowsRepaired += repair.rowsRepaired;
+                stats.table.nodesResettled += repair.nodesResettled;
+            }
+            closed.push_back(edge);
+        }
+        if (!closed.empty()) {
+            chReady_ = false;   // rebuilt on the next CH query
+        }
+    }
+    if (closed.empty()) {
+        return stats;
+    }
+    
+    // Only routes that walk through the connection are wrong now
+    stats.routesInvalidated = routeCache_->eraseIf(
+        [&closed](const RouteKey&, const RouteResult& result) {
+            std::vector<Location*> nodes = result.path.getLocations();
+            for (size_t i = 0; i + 1 < nodes.size(); ++i) {
+                if (std::find(closed.begin(), closed.end(),
+                              std::make_pair(nodes[i], nodes[i + 1])) != closed.end()) {
+                    return true;
+                }
+            }
+            return false;
+        });
+    return stats;
+}
+
+// Reopen a closed connection
+ClosureStats Navigator::reopenConnection(Location* a, Location* b) {
+    if (a == nullptr || b == nullptr) {
+        throw InvalidLocationException("Connection endpoint is null");
+    }
+    
+    struct Reopened {
+        Location* from;
+        Location* to;
+        double weight;
+    };
+    ClosureStats stats;
+    std::vector<Reopened> reopened;
+    std::pair<Location*, Location*> directions[] = { std::make_pair(a, b), std::make_pair(b, a) };
+    {
+        std::lock_guard<std::mutex> lock(preprocessMutex_);
+        for (const std::pair<Location*, Location*>& edge : directions) {
+            if (closedEdges_.erase(edge) == 0) {
+                continue;
+            }
+            uint32_t from = indexOf(edge.first);
+            uint32_t to = indexOf(edge.second);
+            double weight = setEdgeClosed(from, to, false);
+            if (tableReady_) {
+                TableRepairStats repair = allPairs_.edgeOpened(csr_, from, to, weight);
+                stats.table.rowsRepaired += repair.rowsRepaired;
+                stats.table.nodesResettled += repair.nodesResettled;
+            }
+            Reopened entry = { edge.first, edge.second, weight };
+            reopened.push_back(entry);
+        }
+        if (!reopened.empty()) {
+            chReady_ = false;
+        }
+    }
+    if (reopened.empty()) {
+        return stats;
+    }
+    
+    // A leg p -> q can only get shorter through from -> to if
+    // d(p, from) + weight + d(to, q) beats it. The scaled great-circle
+    // distance bounds both d() terms from below (as for A*), and a leg is
+    // never longer than the whole route, so routes failing the test for
+    // every leg are certainly still optimal.
+    auto byId = [this](int id) -> Location* {
+        if (id >= 0 && static_cast<size_t>(id) < idToIndex_.size() && idToIndex_[id] != NO_NODE) {
+            return csr_.nodeAt(idToIndex_[id]);
+        }
+        for (Location* loc : allLocations_) {
+            if (loc->getId() == id) return loc;
+        }
+        return nullptr;
+    };
+    const double scale = heuristicScale_;
+    stats.routesInvalidated = routeCache_->eraseIf(
+        [&](const RouteKey& key, const RouteResult& result) {
+            std::vector<Location*> stops;
+            stops.push_back(byId(key.start));
+            for (int via : key.vias) {
+                stops.push_back(byId(via));
+            }
+            stops.push_back(byId(key.end));
+            for (size_t i = 0; i + 1 < stops.size(); ++i) {
+                if (stops[i] == nullptr || stops[i + 1] == nullptr) {
+                    return true;
+                }
+                for (const Reopened& edge : reopened) {
+                    double bound = scale * (stops[i]->distanceTo(*edge.from) +
+                                            edge.to->distanceTo(*stops[i + 1])) + edge.weight;
+                    if (bound < result.distanceMeters) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        });
+    return stats;
+}
+
+// Is a -> b closed?
+bool Navigator::isConnectionClosed(Location* a, Location* b) const {
+    return closedEdges_.count(std::make_pair(a, b)) > 0;
+}
+
+// Configure the route cache
+void Navigator::setRouteCacheCapacity(size_t capacity, size_t shards) {
+    routeCache_.reset(new RouteCache(capacity, shards));
+}
+
+// Route cache counters
+RouteCacheStats Navigator::getRouteCacheStats() const {
+    return routeCache_->getStats();
+}
+
+// Drop cached routes
+void Navigator::clearRouteCache() {
+    routeCache_->clear();
+}
+
+// Set batch worker count
+void Navigator::setThreadCount(unsigned threads) {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    threadCount_ = threads;
+    pool_.reset();
+}
+
+// Lazily created worker pool
+ThreadPool& Navigator::workerPool() const {
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    if (!pool_) {
+        pool_.reset(new ThreadPool(threadCount_));
+    }
+    return *pool_;
+}
+
+// Set search engine
+void Navigator::setSearchEngine(SearchEngine engine) {
+    engine_ = engine;
+}
+
+// Get search engine
+SearchEngine Navigator::getSearchEngine() const {
+    return engine_;
+}
+
+// Set Dial's weight unit
+void Navigator::setQuantizationStep(double meters) {
+    if (!(meters > 0.0) || meters == INF) {
+        throw std::invalid_argument("Quantization step must be positive");
+    }
+    quantizationStep_ = meters;
+    routeCache_->clear();   // cached Dial routes were rounded to the old step
+}
+
+// Get Dial's weight unit
+double Navigator::getQuantizationStep() const {
+    return quantizationStep_;
+}
+
+// Set Dijkstra queue policy
+void Navigator::setQueuePolicy(QueuePolicy policy) {
+    queuePolicy_ = policy;
+}
+
+// Get Dijkstra queue policy
+QueuePolicy Navigator::getQueuePolicy() const {
+    return queuePolicy_;
+}
+
+// Build contraction hierarchy
+const ContractionHierarchy& Navigator::buildContractionHierarchy() {
+    std::lock_guard<std::mutex> lock(preprocessMutex_);
+    ch_.build(csr_);
+    chReady_ = true;
+    return ch_;
+}
+
+// Lazy, thread-safe CH build (double-checked)
+void Navigator::ensureHierarchy() const {
+    if (chReady_.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(preprocessMutex_);
+    if (!chReady_.load(std::memory_order_relaxed)) {
+        ch_.build(csr_);
+        chReady_.store(true, std::memory_order_release);
+    }
+}
+
+// Enable/disable all-pairs precomputation
+void Navigator::setPrecomputeAllPairs(bool enabled) {
+    precomputeAllPairs_ = enabled;
+    if (enabled) {
+        engine_ = SearchEngine::AllPairsTable;
+    }
+}
+
+// Build all-pairs table
+const AllPairsTable& Navigator::buildAllPairsTable() {
+    std::lock_guard<std::mutex> lock(preprocessMutex_);
+    allPairs_.build(csr_);
+    tableReady_ = true;
+    return allPairs_;
+}
+
+// Lazy, thread-safe table build (double-checked)
+void Navigator::ensureAllPairsTable() const {
+    if (tableReady_.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(preprocessMutex_);
+    if (!tableReady_.load(std::memory_order_relaxed)) {
+        allPairs_.build(csr_);
+        tableReady_.store(true, std::memory_order_release);
+    }
+}
+
+// Get all-pairs table
+const AllPairsTable& Navigator::getAllPairsTable() const {
+    return allPairs_;
 }
 
 // Set navigation mode
@@ -279,7 +1363,7 @@ double Navigator::getEstimatedTime() const {
 }
 
 // Get location by name
-Location* Navigator::getLocationByName(const std::string& name) {
+Location* Navigator::getLocationByName(const std::string& name) const {
     for (Location* loc : allLocations_) {
         if (loc->getName() == name) {
             return loc;
@@ -299,7 +1383,23 @@ const Graph<Location*>& Navigator::getGraph() const {
     return graph_;
 }
 
+// Get routing graph
+const CSRGraph<Location*>& Navigator::getRoutingGraph() const {
+    return csr_;
+}
+
 // Get last path
 Path Navigator::getLastPath() const {
     return lastPath_;
 }
+
+// Get last search counters
+SearchStats Navigator::getLastSearchStats() const {
+    return lastStats_;
+}
+
+// Per-thread search workspace
+SearchWorkspace& Navigator::threadWorkspace(size_t slot) {
+    static thread_local SearchWorkspace workspaces[2];
+    return workspaces[slot < 2 ? slot : 0];
+}
@@ -22,10 +22,26 @@
  * and compute shortest paths between locations.
  */
 #include "Graph.h"
+#include "CSRGraph.h"
+#include "SearchWorkspace.h"
+#include "PriorityQueues.h"
+#include "ContractionHierarchy.h"
+#include "AllPairsTable.h"
+#include "ThreadPool.h"
+#include "RouteCache.h"
+#include "ViaOrderOptimizer.h"
+#include "KShortestPaths.h"
+#include "DeltaStepping.h"
+#include "GraphSnapshot.h"
 #include "NavigationMode.h"
 #include <vector>
 #include <memory>
+#include <string>
 #include <stdexcept>
+#include <mutex>
+#include <atomic>
+#include <set>
+#include <utility>
 
 /**
  * @class PathNotFoundException
@@ -51,6 +67,94 @@ public:
         : std::invalid_argument(message) {}
 };
 
+/**
+ * @enum SearchEngine
+ * @brief Shortest-path algorithm used to answer point-to-point queries
+ */
+enum class SearchEngine {
+    Dijkstra,       ///< Plain Dijkstra from start until end is settled
+    AStar,          ///< A* guided by the great-circle distance to end
+    Bidirectional,  ///< Forward search from start and backward search from end
+    ContractionHierarchies, ///< Upward search on a preprocessed hierarchy
+    AllPairsTable,  ///< Walk a precomputed all-pairs shortest-path-tree table
+    Dial            ///< Bucket-queue Dijkstra on weights rounded to the quantization step
+};
+
+/**
+ * @enum QueuePolicy
+ * @brief Priority queue used by SearchEngine::Dijkstra (see PriorityQueues.h)
+ */
+enum class QueuePolicy {
+    BinaryHeap,     ///< Binary heap with lazy deletion
+    QuaternaryHeap, ///< Indexed 4-ary heap with decrease-key
+    PairingHeap,    ///< Pairing heap with decrease-key
+    RadixHeap       ///< Monotone radix heap on the distance bits
+};
+
+/**
+ * @enum AlternativeMethod
+ * @brief How findAlternatives() generates alternative routes
+ */
+enum class AlternativeMethod {
+    Yen,        ///< Exact k shortest simple paths
+    Penalty     ///< Repeated Dijkstra with penalised reused edges (faster, approximate)
+};
+
+/**
+ * @struct RouteResult
+ * @brief Self-contained answer of a const route query
+ * 
+ * Holds everything a caller needs, so nothing has to be read back from
+ * mutable Navigator state afterwards.
+ */
+struct RouteResult {
+    Path path;                  ///< Full path through all legs
+    double distanceMeters;      ///< Total distance in meters
+    std::string modeName;       ///< Navigation mode used for estimatedMinutes
+    double estimatedMinutes;    ///< ETA in that mode
+    double walkingMinutes;      ///< ETA when walking
+    double cyclingMinutes;      ///< ETA when cycling
+    SearchStats stats;          ///< Search counters summed over all legs
+    
+    RouteResult()
+        : distanceMeters(0.0), estimatedMinutes(0.0),
+          walkingMinutes(0.0), cyclingMinutes(0.0) {}
+};
+
+/**
+ * @struct ReachableLocation
+ * @brief One location inside an isochrone
+ */
+struct ReachableLocation {
+    Location* location;         ///< Reached location
+    double distanceMeters;      ///< Shortest distance from the origin
+    double arrivalMinutes;      ///< Travel time in the isochrone's mode
+};
+
+/**
+ * @struct Isochrone
+ * @brief Everything reachable from an origin within a time budget
+ */
+struct Isochrone {
+    std::vector<ReachableLocation> reachable;   ///< Sorted by arrival time, origin first
+    double budgetMinutes;                       ///< Requested time budget
+    double distanceLimitMeters;                 ///< Budget converted to distance
+    std::string modeName;                       ///< Navigation mode used
+    
+    Isochrone() : budgetMinutes(0.0), distanceLimitMeters(0.0) {}
+};
+
+/**
+ * @struct ClosureStats
+ * @brief What a closeConnection()/reopenConnection() call had to redo
+ */
+struct ClosureStats {
+    size_t routesInvalidated;   ///< Cached routes dropped
+    TableRepairStats table;     ///< All-pairs repair work (zero if no table is built)
+    
+    ClosureStats() : routesInvalidated(0) {}
+};
+
 /**
  * @class Navigator
  * @brief Handles pathfinding and navigation
@@ -64,13 +168,40 @@ public:
  * - Throwing custom exceptions
  * - Validating inputs
  * - Handling error conditions
+ * 
+ * Thread safety: route() and the other const query methods may be called
+ * from many threads at once on a shared Navigator. Setters,
+ * initializeGraph() and the stateful findPath() wrappers must not run
+ * concurrently with them.
  */
 class Navigator {
 private:
     Graph<Location*> graph_;                    ///< Campus graph
+    CSRGraph<Location*> csr_;                   ///< Frozen CSR copy of graph_ used for routing
+    std::vector<uint32_t> idToIndex_;           ///< Location::getId() -> dense CSR index
     std::vector<Location*> allLocations_;       ///< All campus locations
     std::shared_ptr<NavigationMode> currentMode_; ///< Current navigation mode
     Path lastPath_;                             ///< Last calculated path
+    SearchStats lastStats_;                     ///< Counters of the last search
+    SearchEngine engine_;                       ///< Default engine for findPath
+    QueuePolicy queuePolicy_;                   ///< Queue used by Dijkstra
+    double heuristicScale_;                     ///< Keeps the A* heuristic admissible (<= 1)
+    double maxEdgeWeight_;                      ///< Largest finite edge weight (sizes Dial's buckets)
+    double quantizationStep_;                   ///< Dial's weight unit in meters
+    mutable ContractionHierarchy ch_;           ///< Built on first CH query or on demand
+    mutable AllPairsTable allPairs_;            ///< All-pairs table (small campuses)
+    bool precomputeAllPairs_;                   ///< Build allPairs_ in initializeGraph
+    mutable std::mutex preprocessMutex_;        ///< Serialises lazy CH/table builds
+    mutable std::atomic<bool> chReady_;         ///< ch_ is built and read-only
+    mutable std::atomic<bool> tableReady_;      ///< allPairs_ is built and read-only
+    unsigned threadCount_;                      ///< Batch worker threads (0 = all cores)
+    mutable std::unique_ptr<ThreadPool> pool_;  ///< Created on first batch call
+    mutable std::mutex poolMutex_;              ///< Guards lazy pool creation
+    std::unique_ptr<RouteCache> routeCache_;    ///< LRU of recent route() results
+    bool optimizeViaOrder_;                     ///< findPath reorders vias for the shortest tour
+    std::vector<Location*> lastViaOrder_;       ///< Vias in the order the last findPath visited them
+    std::set<std::pair<Location*, Location*>> closedEdges_; ///< Temporarily closed directed connections
+    std::vector<std::unique_ptr<Location>> ownedLocations_; ///< Locations created by loadSnapshot()
     
     /**
      * @class ViaSelectionException
@@ -86,24 +217,163 @@ private:
      * @brief Dijkstra's algorithm implementation (PRIVATE - ABSTRACTION)
      * @param start Start location
      * @param end End location
+     * @param stats Output: search counters
      * @return Shortest path
      * @throws PathNotFoundException if no path exists
      * 
      * This method is private - users don't need to know how pathfinding works
      */
-    Path dijkstraShortestPath(Location* start, Location* end);
+    Path dijkstraShortestPath(Location* start, Location* end, SearchStats& stats) const;
     
     /**
-     * @brief Reconstruct path from Dijkstra results
+     * @brief Dijkstra with a given priority queue policy
+     * @tparam Queue One of the queues in PriorityQueues.h (one instance per thread)
+     */
+    template<typename Queue>
+    Path dijkstraWithQueue(Location* start, Location* end, SearchStats& stats) const;
+    
+    /**
+     * @brief A* search using Location::distanceTo as heuristic
+     * @param start Start location
+     * @param end End location
+     * @return Shortest path (same result as Dijkstra)
+     * @throws PathNotFoundException if no path exists
+     */
+    Path aStarShortestPath(Location* start, Location* end, SearchStats& stats) const;
+    
+    /**
+     * @brief Bidirectional Dijkstra (forward from start, backward from end)
      * @param start Start location
      * @param end End location
-     * @param previous Map of previous nodes
-     * @param distances Map of distances
+     * @return Shortest path spliced at the meeting node
+     * @throws PathNotFoundException if no path exists
+     */
+    Path bidirectionalShortestPath(Location* start, Location* end, SearchStats& stats) const;
+    
+    /**
+     * @brief Query the contraction hierarchy and unpack shortcuts
+     * @param start Start location
+     * @param end End location
+     * @return Shortest path over real campus locations
+     * @throws PathNotFoundException if no path exists
+     */
+    Path hierarchyShortestPath(Location* start, Location* end, SearchStats& stats) const;
+    
+    /**
+     * @brief Answer a query by walking the all-pairs tree table
+     * @param start Start location
+     * @param end End location
+     * @return Shortest path
+     * @throws PathNotFoundException if no path exists
+     */
+    Path tableShortestPath(Location* start, Location* end, SearchStats& stats) const;
+    
+    /**
+     * @brief Dial's algorithm on integer weights round(weight / quantizationStep_)
+     * @param start Start location
+     * @param end End location
+     * @return Shortest path for the rounded weights, with its true length
+     * @throws PathNotFoundException if no path exists
+     * @throws std::runtime_error if the step needs too many buckets
+     */
+    Path dialShortestPath(Location* start, Location* end, SearchStats& stats) const;
+    
+    /**
+     * @brief Reconstruct path from Dijkstra results
+     * @param start Dense index of the start location
+     * @param end Dense index of the end location
+     * @param workspace Workspace holding predecessors and distances
      * @return Reconstructed path
      */
-    Path reconstructPath(Location* start, Location* end,
-                         const std::map<Location*, Location*>& previous,
-                         const std::map<Location*, double>& distances);
+    Path reconstructPath(uint32_t start, uint32_t end,
+                         const SearchWorkspace& workspace) const;
+    
+    /**
+     * @brief Distances from one node to a set of nodes
+     * @param source Dense start index
+     * @param targets Dense target indices (duplicates allowed)
+     * @param row Output: row[i] = distance to targets[i], infinity if unreachable
+     * 
+     * Single Dijkstra that stops as soon as every target is settled.
+     */
+    void oneToMany(uint32_t source, const std::vector<uint32_t>& targets, double* row) const;
+    
+    /**
+     * @brief Longest distance a mode covers within a time budget
+     * @param mode Navigation mode
+     * @param minutes Time budget
+     * @return Distance in meters, or a negative value if even 0 m takes longer
+     * 
+     * Inverts NavigationMode::calculateTime by bisection, so any monotone
+     * time model works, not just distance / speed.
+     */
+    static double distanceWithin(const NavigationMode& mode, double minutes);
+    
+    /**
+     * @brief Run one start -> end leg on the given engine
+     * @param start Start location
+     * @param end End location
+     * @param engine Search engine
+     * @param stats Output: search counters
+     * @return Shortest path
+     */
+    Path shortestLeg(Location* start, Location* end, SearchEngine engine,
+                     SearchStats& stats) const;
+    
+    /**
+     * @brief Re-freeze graph_ into csr_ and drop everything derived from it
+     * 
+     * Called after every change to graph_. Cached routes need no explicit
+     * flush: they are tagged with the graph version and expire by themselves.
+     * Closures whose connection still exists are applied to the new csr_.
+     */
+    void rebuildRoutingGraph();
+    
+    /**
+     * @brief Drop the hierarchy and table and re-index location ids for csr_
+     */
+    void resetDerivedData();
+    
+    /**
+     * @brief Copy a loaded snapshot into graph_ before the first edit
+     * 
+     * After loadSnapshot() graph_ is empty and csr_ reads the mapped file.
+     * Edits and closures need graph_, so it is filled from csr_ in CSR
+     * edge order (which setEdgeClosed relies on). No-op otherwise.
+     */
+    void materializeGraph();
+    
+    /**
+     * @brief Close or restore every routing edge from -> to in csr_
+     * @param from Dense tail index
+     * @param to Dense head index
+     * @param closed True sets the weights to infinity, false restores them from graph_
+     * @return Shortest restored weight (infinity when closing)
+     */
+    double setEdgeClosed(uint32_t from, uint32_t to, bool closed);
+    
+    /**
+     * @brief Build the contraction hierarchy once, thread-safely
+     */
+    void ensureHierarchy() const;
+    
+    /**
+     * @brief Build the all-pairs table once, thread-safely
+     */
+    void ensureAllPairsTable() const;
+    
+    /**
+     * @brief Get (creating on first use) the batch worker pool
+     */
+    ThreadPool& workerPool() const;
+    
+    /**
+     * @brief Map a location to its dense routing index (API boundary)
+     * @param loc Location pointer
+     * @return Dense index in [0, node count)
+     * @throws InvalidLocationException if location is not in the graph
+     */
+    uint32_t indexOf(Location* loc) const;
     
 public:
     /**
@@ -125,6 +395,57 @@ public:
                          const std::vector<std::pair<int, int>>& connections,
                          const std::vector<double>& distances);
     
+    /**
+     * @brief Write the routing graph to a binary snapshot file
+     * @param path Output file
+     * @throws SnapshotFormatException if the file cannot be written
+     * 
+     * Closed connections are stored open; closures are not persisted.
+     * Only the Location base fields (id, name, coordinates, description)
+     * are kept.
+     */
+    void saveSnapshot(const std::string& path) const;
+    
+    /**
+     * @brief Replace the graph with a memory-mapped snapshot
+     * @param path Snapshot written by saveSnapshot()
+     * @param verifyChecksum Check the file checksum (reads it once)
+     * @throws SnapshotFormatException if the file is missing or invalid
+     * 
+     * Queries read the CSR arrays straight from the mapped pages; only
+     * one Location per node is created (owned by the Navigator). The map
+     * based graph returned by getGraph() stays empty until the first
+     * edit or closure, which copies the snapshot into it.
+     */
+    void loadSnapshot(const std::string& path, bool verifyChecksum = true);
+    
+    /**
+     * @brief Const, reentrant route query
+     * @param start Start location
+     * @param end End location
+     * @param vias Ordered via locations (may be empty)
+     * @param engine Search engine for every leg
+     * @return Path, distance and per-mode ETA
+     * @throws InvalidLocationException if a location is invalid
+     * @throws PathNotFoundException if no path exists
+     * 
+     * Reads no mutable Navigator state besides the configured mode, so a
+     * single Navigator can serve many threads. Answers repeated queries
+     * from the route cache when one is configured.
+     */
+    RouteResult route(Location* start, Location* end,
+                      const std::vector<Location*>& vias, SearchEngine engine) const;
+    
+    /**
+     * @brief Const route query using the default engine
+     * @param start Start location
+     * @param end End location
+     * @param vias Ordered via locations (may be empty)
+     * @return Path, distance and per-mode ETA
+     */
+    RouteResult route(Location* start, Location* end,
+                      const std::vector<Location*>& vias = std::vector<Location*>()) const;
+    
     /**
      * @brief Find shortest path between two locations (PUBLIC - SIMPLE INTERFACE)
      * @param startName Start location name
@@ -145,16 +466,298 @@ public:
      * @return Shortest path
      */
     Path findPath(Location* start, Location* end);
+    
+    /**
+     * @brief Find path by location pointers with an explicit engine
+     * @param start Start location
+     * @param end End location
+     * @param engine Engine to use for this query only
+     * @return Shortest path
+     */
+    Path findPath(Location* start, Location* end, SearchEngine engine);
     /**
      * @brief Find path that passes through given via locations in order
      * @param start Start location
      * @param end End location
-     * @param vias Ordered vector of via locations (may be empty)
+     * @param vias Ordered vector of via locations (may be empty; null entries are skipped)
      * @return Combined path going through all vias
      * @throws ViaSelectionException if a via equals start or end
+     * 
+     * With setOptimizeViaOrder(true) the vias are visited in the shortest
+     * order; getLastViaOrder() returns that order.
      */
     Path findPath(Location* start, Location* end, const std::vector<Location*>& vias);
     
+    /**
+     * @brief Up to k alternative routes between two locations
+     * @param start Start location
+     * @param end End location
+     * @param k Maximum number of routes
+     * @param method Yen (exact k shortest) or Penalty (interactive)
+     * @return Distinct simple paths sorted with Path::operator< (shortest first)
+     * @throws InvalidLocationException if a location is invalid
+     * @throws PathNotFoundException if no path exists
+     */
+    std::vector<Path> findAlternatives(Location* start, Location* end, size_t k,
+                                       AlternativeMethod method = AlternativeMethod::Yen) const;
+    
+    /**
+     * @brief Locations reachable within a time budget (isochrone)
+     * @param origin Start location
+     * @param minutes Time budget in minutes
+     * @param mode Navigation mode whose calculateTime defines travel time
+     * @return Reachable locations with distances and arrival times
+     * @throws InvalidLocationException if origin is invalid
+     * @throws std::invalid_argument if minutes is negative
+     * 
+     * One Dijkstra from origin that stops as soon as the frontier passes
+     * the distance the mode covers in the budget. distanceLimitMeters lets
+     * a renderer shade partially covered edges as well.
+     */
+    Isochrone reachableWithin(Location* origin, double minutes, const NavigationMode& mode) const;
+    
+    /**
+     * @brief Isochrone in the current navigation mode
+     * @param origin Start location
+     * @param minutes Time budget in minutes
+     * @return Reachable locations with distances and arrival times
+     */
+    Isochrone reachableWithin(Location* origin, double minutes) const;
+    
+    /**
+     * @brief Shortest distances from every source to every target
+     * @param sources Row locations
+     * @param targets Column locations
+     * @return Dense row-major matrix: element [i * targets.size() + j] is the
+     *         distance from sources[i] to targets[j], infinity if unreachable
+     * @throws InvalidLocationException if any location is invalid
+     * 
+     * Runs one Dijkstra per source that stops once every target is settled,
+     * with sources spread over the internal worker pool. No Path objects are
+     * built and unreachable pairs do not throw.
+     */
+    std::vector<double> distanceMatrix(const std::vector<Location*>& sources,
+                                       const std::vector<Location*>& targets) const;
+    
+    /**
+     * @brief Shortest distances from one location to every location
+     * @param source Origin
+     * @param delta Delta-stepping bucket width in meters (0 = tuned from the weights)
+     * @return Distance per routing index (see getRoutingGraph().nodeAt()),
+     *         infinity where unreachable
+     * @throws InvalidLocationException if source is invalid
+     * 
+     * Full single-source trees for analytics on large graphs: a
+     * Delta-stepping search relaxes each bucket's edges in parallel on the
+     * worker pool. The distances are identical to Dijkstra's.
+     */
+    std::vector<double> distancesFrom(Location* source, double delta = 0.0) const;
+    
+    /**
+     * @brief Shortest order in which to visit a set of vias
+     * @param start Start location
+     * @param end End location
+     * @param vias Vias in any order
+     * @return The same vias, reordered to minimise start -> vias -> end
+     * @throws InvalidLocationException if a location is invalid
+     * 
+     * Builds the stop-to-stop distance matrix with distanceMatrix(), then
+     * solves it exactly (Held-Karp) for up to
+     * ViaOrderOptimizer::HELD_KARP_LIMIT vias and heuristically above.
+     */
+    std::vector<Location*> optimizeViaOrder(Location* start, Location* end,
+                                            const std::vector<Location*>& vias) const;
+    
+    /**
+     * @brief Let findPath(start, end, vias) choose the via order
+     * @param enabled True to visit vias in the shortest order instead of as given
+     */
+    void setOptimizeViaOrder(bool enabled);
+    
+    /**
+     * @brief Whether findPath reorders vias
+     * @return True if via order optimization is on
+     */
+    bool getOptimizeViaOrder() const;
+    
+    /**
+     * @brief Vias in the order the last findPath(start, end, vias) visited them
+     * @return Via sequence (reordered when optimization is on)
+     */
+    std::vector<Location*> getLastViaOrder() const;
+    
+    /**
+     * @brief Find many routes at once on the internal work-stealing pool
+     * @param pairs (start, end) pairs
+     * @return One path per pair, in input order; an empty Path where no
+     *         route exists
+     * @throws InvalidLocationException if any location is invalid
+     * 
+     * Each worker thread searches with its own workspace. Does not touch
+     * lastPath_.
+     */
+    std::vector<Path> findPaths(const std::vector<std::pair<Location*, Location*>>& pairs) const;
+    
+    /**
+     * @brief Add a two-way connection and refresh the routing data
+     * @param a First location (added to the graph if new)
+     * @param b Second location (added to the graph if new)
+     * @param distance Length in meters
+     * @throws InvalidLocationException if a location is null
+     */
+    void addConnection(Location* a, Location* b, double distance);
+    
+    /**
+     * @brief Remove both directions of a connection
+     * @param a First location
+     * @param b Second location
+     */
+    void removeConnection(Location* a, Location* b);
+    
+    /**
+     * @brief Remove a location and every connection touching it
+     * @param loc Location to remove
+     */
+    void removeLocation(Location* loc);
+    
+    /**
+     * @brief Temporarily close both directions of a connection
+     * @param a First location
+     * @param b Second location
+     * @return Cached routes dropped and all-pairs repair work
+     * @throws InvalidLocationException if the locations are not connected
+     * 
+     * Meant for gates that lock at night or paths shut for works. The graph
+     * itself is unchanged; the routing copy gets infinite weights, a built
+     * all-pairs table is repaired in place, only cached routes that use the
+     * connection are dropped and the contraction hierarchy is rebuilt on
+     * its next query. Must not run concurrently with queries.
+     */
+    ClosureStats closeConnection(Location* a, Location* b);
+    
+    /**
+     * @brief Reopen a connection closed by closeConnection()
+     * @param a First location
+     * @param b Second location
+     * @return Cached routes dropped and all-pairs repair work
+     * 
+     * Cached routes are kept when a straight-line lower bound shows the
+     * connection cannot shorten them. Reopening an open connection is a
+     * no-op. Must not run concurrently with queries.
+     */
+    ClosureStats reopenConnection(Location* a, Location* b);
+    
+    /**
+     * @brief Check whether a connection is currently closed
+     * @param a First location
+     * @param b Second location
+     * @return True if a -> b is closed
+     */
+    bool isConnectionClosed(Location* a, Location* b) const;
+    
+    /**
+     * @brief Enable the route cache
+     * @param capacity Maximum cached routes (0 disables the cache)
+     * @param shards Independently locked partitions
+     * 
+     * Entries are keyed by start, end, ordered vias, navigation mode and
+     * engine, and expire automatically when the graph changes.
+     */
+    void setRouteCacheCapacity(size_t capacity, size_t shards = 16);
+    
+    /**
+     * @brief Get route cache hit/miss/eviction counters
+     * @return Counter snapshot (all zero when the cache is disabled)
+     */
+    RouteCacheStats getRouteCacheStats() const;
+    
+    /**
+     * @brief Drop all cached routes
+     */
+    void clearRouteCache();
+    
+    /**
+     * @brief Set the number of batch worker threads
+     * @param threads Worker count (0 = all hardware threads)
+     */
+    void setThreadCount(unsigned threads);
+    
+    /**
+     * @brief Set the default search engine used by findPath
+     * @param engine Search engine
+     */
+    void setSearchEngine(SearchEngine engine);
+    
+    /**
+     * @brief Get the default search engine
+     * @return Search engine
+     */
+    SearchEngine getSearchEngine() const;
+    
+    /**
+     * @brief Set the weight unit of SearchEngine::Dial
+     * @param meters Step each edge weight is rounded to (e.g. 1.0 or 0.1)
+     * @throws std::invalid_argument if the step is not positive
+     * 
+     * Each edge is off by at most step / 2, so the returned path is at
+     * most (edges on it + edges on the true shortest path) * step / 2
+     * longer than the exact shortest path. Its reported length is always
+     * the exact length of the path returned. Smaller steps tighten the
+     * bound but need maxEdgeWeight / step buckets.
+     */
+    void setQuantizationStep(double meters);
+    
+    /**
+     * @brief Get the weight unit of SearchEngine::Dial
+     * @return Step in meters
+     */
+    double getQuantizationStep() const;
+    
+    /**
+     * @brief Set the priority queue used by the Dijkstra engine
+     * @param policy Queue implementation
+     * 
+     * All policies return identical distances; which is fastest depends on
+     * the graph's shape (see the benchmark).
+     */
+    void setQueuePolicy(QueuePolicy policy);
+    
+    /**
+     * @brief Get the Dijkstra priority queue policy
+     * @return Queue implementation
+     */
+    QueuePolicy getQueuePolicy() const;
+    
+    /**
+     * @brief Run Contraction Hierarchies preprocessing now
+     * 
+     * Otherwise it runs on the first ContractionHierarchies query.
+     * @return The built hierarchy (shortcut count, build time)
+     */
+    const ContractionHierarchy& buildContractionHierarchy();
+    
+    /**
+     * @brief Precompute all-pairs distances and trees in initializeGraph
+     * 
+     * Worthwhile for campus-sized graphs (hundreds of nodes); memory is
+     * O(V^2). Enabling it also makes AllPairsTable the default engine.
+     * Call before initializeGraph, or call buildAllPairsTable() afterwards.
+     * @param enabled True to precompute
+     */
+    void setPrecomputeAllPairs(bool enabled);
+    
+    /**
+     * @brief Build the all-pairs table now (one Dijkstra per source, all cores)
+     * @return The table (memory and build time)
+     */
+    const AllPairsTable& buildAllPairsTable();
+    
+    /**
+     * @brief Get the all-pairs table (empty unless built)
+     * @return The table
+     */
+    const AllPairsTable& getAllPairsTable() const;
+    
     /**
      * @brief Set navigation mode
      * @param mode Navigation mode pointer
@@ -179,7 +782,7 @@ public:
      * @return Location pointer
      * @throws InvalidLocationException if not found
      */
-    Location* getLocationByName(const std::string& name);
+    Location* getLocationByName(const std::string& name) const;
     
     /**
      * @brief Get all locations
@@ -193,11 +796,34 @@ public:
      */
     const Graph<Location*>& getGraph() const;
     
+    /**
+     * @brief Get the frozen CSR snapshot used for routing
+     * @return Reference to the CSR graph
+     */
+    const CSRGraph<Location*>& getRoutingGraph() const;
+    
     /**
      * @brief Get last calculated path
      * @return Last path
      */
     Path getLastPath() const;
+    
+    /**
+     * @brief Get search counters of the last single-leg query
+     * @return Nodes settled, edges relaxed and search buffer allocations
+     */
+    SearchStats getLastSearchStats() const;
+    
+    /**
+     * @brief Get one of the calling thread's search workspaces
+     * 
+     * The workspace persists between queries, so after warm-up a query
+     * performs no heap allocation inside the search itself. Slot 0 is the
+     * forward search; slot 1 is used by backward searches.
+     * @param slot Workspace slot (0 or 1)
+     * @return Workspace owned by the current thread
+     */
+    static SearchWorkspace& threadWorkspace(size_t slot = 0);
 };
 
 #endif // NAVIGATOR_H
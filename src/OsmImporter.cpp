@@ -0,0 +1,1231 @@
+/**
+ * @file OsmImporter.cpp
+ * @brief Implementation of the OSM XML / PBF importer.
+ */
+
+#include "OsmImporter.h"
+#include "ThreadPool.h"
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <cctype>
+#include <limits>
+#include <functional>
+#include <memory>
+#include <atomic>
+#ifdef CAMPUS_NAV_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+// Limits from the PBF specification
+const size_t MAX_BLOB_HEADER_SIZE = 64 * 1024;
+const size_t MAX_BLOB_SIZE = 32 * 1024 * 1024;
+
+// Bytes read from an XML file at a time
+const size_t XML_BUFFER_SIZE = 1 << 16;
+
+// Node index that is not set
+const uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+
+double millisSince(std::chrono::steady_clock::time_point started) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - started).count();
+}
+
+// ---------------------------------------------------------------------------
+// Way filter
+// ---------------------------------------------------------------------------
+
+/**
+ * @struct WayTags
+ * @brief The tags of a way that decide whether it is kept
+ */
+struct WayTags {
+    std::string highway;
+    std::string foot;
+    std::string bicycle;
+    std::string access;
+
+    void clear() {
+        highway.clear();
+        foot.clear();
+        bicycle.clear();
+        access.clear();
+    }
+
+    void set(const char* key, size_t keyLength, const char* value, size_t valueLength) {
+        std::string* slot = nullptr;
+        if (keyLength == 7 && std::memcmp(key, "highway", 7) == 0) slot = &highway;
+        else if (keyLength == 4 && std::memcmp(key, "foot", 4) == 0) slot = &foot;
+        else if (keyLength == 7 && std::memcmp(key, "bicycle", 7) == 0) slot = &bicycle;
+        else if (keyLength == 6 && std::memcmp(key, "access", 6) == 0) slot = &access;
+        if (slot != nullptr) {
+            slot->assign(value, valueLength);
+        }
+    }
+};
+
+bool isOneOf(const std::string& value, const char* const* list) {
+    for (; *list != nullptr; ++list) {
+        if (value == *list) return true;
+    }
+    return false;
+}
+
+// Explicit permission in foot=* / bicycle=*
+bool isAllowed(const std::string& value) {
+    static const char* const values[] = { "yes", "designated", "permissive", "official", nullptr };
+    return isOneOf(value, values);
+}
+
+bool isForbidden(const std::string& value) {
+    static const char* const values[] = { "no", "private", "use_sidepath", nullptr };
+    return isOneOf(value, values);
+}
+
+// Usable on foot: walkable highway types unless foot=no or access=no
+bool isWalkable(const WayTags& tags) {
+    static const char* const highways[] = {
+        "footway", "path", "pedestrian", "steps", "track", "living_street", "residential",
+        "service", "unclassified", "tertiary", "tertiary_link", "secondary", "secondary_link",
+        "primary", "primary_link", "trunk", "trunk_link", "cycleway", "bridleway", "corridor",
+        "road", nullptr };
+    if (isForbidden(tags.foot)) return false;
+    if (isAllowed(tags.foot)) return !tags.highway.empty();
+    if (isForbidden(tags.access)) return false;
+    return isOneOf(tags.highway, highways);
+}
+
+// Usable by bicycle: no steps, and footways only where bicycles are allowed
+bool isCyclable(const WayTags& tags) {
+    static const char* const highways[] = {
+        "cycleway", "path", "track", "living_street", "residential", "service",
+        "unclassified", "tertiary", "tertiary_link", "secondary", "secondary_link",
+        "primary", "primary_link", "trunk", "trunk_link", "road", nullptr };
+    if (isForbidden(tags.bicycle)) return false;
+    if (isAllowed(tags.bicycle)) return !tags.highway.empty() && tags.highway != "steps";
+    if (isForbidden(tags.access)) return false;
+    return isOneOf(tags.highway, highways);
+}
+
+bool keepWay(const WayTags& tags, const OsmImportOptions& options) {
+    if (tags.highway.empty()) return false;
+    return (options.walking && isWalkable(tags)) || (options.cycling && isCyclable(tags));
+}
+
+// ---------------------------------------------------------------------------
+// Import state shared by the XML and PBF readers
+// ---------------------------------------------------------------------------
+
+/**
+ * @struct KeptWays
+ * @brief Node references of the kept ways, concatenated
+ */
+struct KeptWays {
+    std::vector<int64_t> refs;      ///< OSM node ids
+    std::vector<size_t> ends;       ///< ends[w] = one past the last ref of way w
+
+    void add(const int64_t* first, size_t count) {
+        if (count < 2) return;      // a single node is not a way
+        refs.insert(refs.end(), first, first + count);
+        ends.push_back(refs.size());
+    }
+};
+
+/**
+ * @struct NodeTable
+ * @brief Coordinates of the referenced nodes, indexed like the sorted ids
+ *
+ * Filled concurrently by PBF blocks. Distinct ids have their own index;
+ * an id repeated in several blocks (a malformed or merged extract) would
+ * be written by two threads, so the first writer claims the index through
+ * its atomic flag and later copies are ignored. The coordinates are read
+ * only after the pass, once the pool has finished.
+ */
+struct NodeTable {
+    std::vector<int64_t> ids;                   ///< Sorted distinct referenced ids
+    std::vector<double> latitude;
+    std::vector<double> longitude;
+    std::vector<std::atomic<uint8_t>> found;    ///< Coordinates claimed by a writer
+
+    // Size the coordinate arrays to ids, nothing found yet
+    void reset() {
+        latitude.assign(ids.size(), 0.0);
+        longitude.assign(ids.size(), 0.0);
+        std::vector<std::atomic<uint8_t>>(ids.size()).swap(found);
+    }
+
+    void store(int64_t id, double lat, double lon) {
+        std::vector<int64_t>::const_iterator it = std::lower_bound(ids.begin(), ids.end(), id);
+        if (it == ids.end() || *it != id) return;
+        if (!(lat >= -90.0 && lat <= 90.0 && lon >= -180.0 && lon <= 180.0)) return;
+        size_t index = static_cast<size_t>(it - ids.begin());
+        uint8_t unclaimed = 0;
+        if (!found[index].compare_exchange_strong(unclaimed, 1)) return;
+        latitude[index] = lat;
+        longitude[index] = lon;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Protocol buffer decoding (the subset PBF needs)
+// ---------------------------------------------------------------------------
+
+/**
+ * @class ProtoReader
+ * @brief Iterates over the fields of one encoded protobuf message
+ */
+class ProtoReader {
+private:
+    const unsigned char* p_;
+    const unsigned char* end_;
+    uint32_t field_;
+    uint32_t wireType_;
+
+    static OsmFormatException corrupt() {
+        return OsmFormatException("Corrupt PBF block: truncated protobuf message");
+    }
+
+public:
+    ProtoReader() : p_(nullptr), end_(nullptr), field_(0), wireType_(0) {}
+
+    ProtoReader(const unsigned char* data, size_t size)
+        : p_(data), end_(data + size), field_(0), wireType_(0) {}
+
+    bool next() {
+        if (p_ >= end_) return false;
+        uint64_t key = varint();
+        field_ = static_cast<uint32_t>(key >> 3);
+        wireType_ = static_cast<uint32_t>(key & 7);
+        return true;
+    }
+
+    uint32_t field() const { return field_; }
+    uint32_t wireType() const { return wireType_; }
+    bool atEnd() const { return p_ >= end_; }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p_ >= end_) throw corrupt();
+            unsigned char byte = *p_++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return value;
+        }
+        throw corrupt();
+    }
+
+    int64_t svarint() {
+        uint64_t value = varint();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    // Length-delimited payload (bytes, string, sub-message, packed array)
+    ProtoReader bytes() {
+        if (wireType_ != 2) throw OsmFormatException("Corrupt PBF block: unexpected wire type");
+        uint64_t size = varint();
+        if (size > static_cast<uint64_t>(end_ - p_)) throw corrupt();
+        ProtoReader inner(p_, static_cast<size_t>(size));
+        p_ += size;
+        return inner;
+    }
+
+    const unsigned char* data() const { return p_; }
+    size_t size() const { return static_cast<size_t>(end_ - p_); }
+
+    void skip() {
+        size_t count = 0;
+        switch (wireType_) {
+        case 0: varint(); return;
+        case 1: count = 8; break;
+        case 2: bytes(); return;
+        case 5: count = 4; break;
+        default: throw OsmFormatException("Corrupt PBF block: unsupported wire type");
+        }
+        if (count > size()) throw corrupt();
+        p_ += count;
+    }
+
+    // Packed or single varint field, appended to out
+    void appendVarints(std::vector<uint32_t>& out) {
+        if (wireType_ == 0) {
+            out.push_back(static_cast<uint32_t>(varint()));
+            return;
+        }
+        ProtoReader packed = bytes();
+        while (!packed.atEnd()) {
+            out.push_back(static_cast<uint32_t>(packed.varint()));
+        }
+    }
+
+    // Packed or single zigzag field, appended to out
+    void appendSignedVarints(std::vector<int64_t>& out) {
+        if (wireType_ == 0) {
+            out.push_back(svarint());
+            return;
+        }
+        ProtoReader packed = bytes();
+        while (!packed.atEnd()) {
+            out.push_back(packed.svarint());
+        }
+    }
+};
+
+/**
+ * @struct PbfBlob
+ * @brief One OSMData blob read from the file, plus its decoding scratch
+ */
+struct PbfBlob {
+    size_t index;                       ///< Position among the data blobs
+    std::vector<unsigned char> raw;     ///< Encoded Blob message
+    std::vector<unsigned char> data;    ///< Decompressed PrimitiveBlock
+};
+
+// Decompress a Blob message into out
+void decompressBlob(const std::vector<unsigned char>& blob, std::vector<unsigned char>& out) {
+    ProtoReader reader(blob.data(), blob.size());
+    uint64_t rawSize = 0;
+    ProtoReader raw, zlibData;
+    bool haveRaw = false, haveZlib = false;
+    while (reader.next()) {
+        switch (reader.field()) {
+        case 1: raw = reader.bytes(); haveRaw = true; break;
+        case 2: rawSize = reader.varint(); break;
+        case 3: zlibData = reader.bytes(); haveZlib = true; break;
+        case 4: case 6: case 7: case 8:
+            throw OsmFormatException("Unsupported PBF blob compression (only raw and zlib are supported)");
+        default: reader.skip(); break;
+        }
+    }
+    if (haveRaw) {
+        out.assign(raw.data(), raw.data() + raw.size());
+        return;
+    }
+    if (!haveZlib) {
+        throw OsmFormatException("Corrupt PBF blob: no data");
+    }
+    if (rawSize > MAX_BLOB_SIZE) {
+        throw OsmFormatException("Corrupt PBF blob: block larger than 32 MiB");
+    }
+#ifdef CAMPUS_NAV_HAVE_ZLIB
+    out.resize(static_cast<size_t>(rawSize));
+    uLongf outSize = static_cast<uLongf>(rawSize);
+    int status = uncompress(out.data(), &outSize, zlibData.data(),
+                            static_cast<uLong>(zlibData.size()));
+    if (status != Z_OK || outSize != rawSize) {
+        throw OsmFormatException("Corrupt PBF blob: zlib data does not inflate to raw_size");
+    }
+#else
+    (void)zlibData;
+    throw OsmFormatException("PBF file uses zlib compression; rebuild with zlib "
+                             "(CAMPUS_NAV_HAVE_ZLIB) to read it");
+#endif
+}
+
+/**
+ * @struct BlockStrings
+ * @brief String table and coordinate scaling of one PrimitiveBlock
+ */
+struct BlockStrings {
+    std::vector<std::pair<const char*, size_t>> strings;
+    std::vector<ProtoReader> groups;
+    int64_t granularity;
+    int64_t latOffset;
+    int64_t lonOffset;
+
+    // Scan the block header fields; groups are decoded by the caller
+    void read(const std::vector<unsigned char>& block) {
+        strings.clear();
+        groups.clear();
+        granularity = 100;
+        latOffset = 0;
+        lonOffset = 0;
+        ProtoReader reader(block.data(), block.size());
+        while (reader.next()) {
+            switch (reader.field()) {
+            case 1: {
+                ProtoReader table = reader.bytes();
+                while (table.next()) {
+                    if (table.field() == 1) {
+                        ProtoReader s = table.bytes();
+                        strings.push_back(std::make_pair(
+                            reinterpret_cast<const char*>(s.data()), s.size()));
+                    } else {
+                        table.skip();
+                    }
+                }
+                break;
+            }
+            case 2: groups.push_back(reader.bytes()); break;
+            case 17: granularity = static_cast<int64_t>(reader.varint()); break;
+            case 19: latOffset = static_cast<int64_t>(reader.varint()); break;
+            case 20: lonOffset = static_cast<int64_t>(reader.varint()); break;
+            default: reader.skip(); break;
+            }
+        }
+    }
+
+    const std::pair<const char*, size_t>& string(uint32_t index) const {
+        if (index >= strings.size()) {
+            throw OsmFormatException("Corrupt PBF block: string index out of range");
+        }
+        return strings[index];
+    }
+
+    double latitude(int64_t raw) const {
+        return 1e-9 * static_cast<double>(latOffset + granularity * raw);
+    }
+
+    double longitude(int64_t raw) const {
+        return 1e-9 * static_cast<double>(lonOffset + granularity * raw);
+    }
+};
+
+/**
+ * @struct WayBlockResult
+ * @brief Pass-1 output of one block, merged in file order
+ */
+struct WayBlockResult {
+    PbfBlob blob;
+    BlockStrings block;
+    KeptWays ways;
+    size_t waysScanned;
+    bool hasNodes;
+    // Scratch
+    std::vector<uint32_t> keys;
+    std::vector<uint32_t> values;
+    std::vector<int64_t> refs;
+    WayTags tags;
+};
+
+// Pass 1 on one block: keep walkable / cyclable ways
+void decodeWays(WayBlockResult& result, const OsmImportOptions& options) {
+    result.ways.refs.clear();
+    result.ways.ends.clear();
+    result.waysScanned = 0;
+    result.hasNodes = false;
+    decompressBlob(result.blob.raw, result.blob.data);
+    result.block.read(result.blob.data);
+
+    for (ProtoReader group : result.block.groups) {
+        while (group.next()) {
+            if (group.field() == 1 || group.field() == 2) {
+                result.hasNodes = true;
+                group.skip();
+                continue;
+            }
+            if (group.field() != 3) {
+                group.skip();
+                continue;
+            }
+            ++result.waysScanned;
+            result.keys.clear();
+            result.values.clear();
+            result.refs.clear();
+            ProtoReader way = group.bytes();
+            while (way.next()) {
+                switch (way.field()) {
+                case 2: way.appendVarints(result.keys); break;
+                case 3: way.appendVarints(result.values); break;
+                case 8: way.appendSignedVarints(result.refs); break;
+                default: way.skip(); break;
+                }
+            }
+            if (result.keys.size() != result.values.size()) {
+                throw OsmFormatException("Corrupt PBF block: way keys and values differ in length");
+            }
+            result.tags.clear();
+            for (size_t i = 0; i < result.keys.size(); ++i) {
+                const std::pair<const char*, size_t>& key = result.block.string(result.keys[i]);
+                const std::pair<const char*, size_t>& value = result.block.string(result.values[i]);
+                result.tags.set(key.first, key.second, value.first, value.second);
+            }
+            if (!keepWay(result.tags, options)) continue;
+            // Refs are delta coded
+            for (size_t i = 1; i < result.refs.size(); ++i) {
+                result.refs[i] += result.refs[i - 1];
+            }
+            result.ways.add(result.refs.data(), result.refs.size());
+        }
+    }
+}
+
+/**
+ * @struct NodeBlockResult
+ * @brief Pass-2 scratch of one block
+ */
+struct NodeBlockResult {
+    PbfBlob blob;
+    BlockStrings block;
+    size_t nodesScanned;
+    std::vector<int64_t> ids;
+    std::vector<int64_t> lats;
+    std::vector<int64_t> lons;
+};
+
+// Pass 2 on one block: coordinates of referenced nodes
+void decodeNodes(NodeBlockResult& result, NodeTable& table) {
+    result.nodesScanned = 0;
+    decompressBlob(result.blob.raw, result.blob.data);
+    result.block.read(result.blob.data);
+    const BlockStrings& block = result.block;
+
+    for (ProtoReader group : result.block.groups) {
+        while (group.next()) {
+            if (group.field() == 1) {
+                // Plain Node
+                ProtoReader node = group.bytes();
+                int64_t id = 0, lat = 0, lon = 0;
+                while (node.next()) {
+                    switch (node.field()) {
+                    case 1: id = node.svarint(); break;
+                    case 8: lat = node.svarint(); break;
+                    case 9: lon = node.svarint(); break;
+                    default: node.skip(); break;
+                    }
+                }
+                ++result.nodesScanned;
+                table.store(id, block.latitude(lat), block.longitude(lon));
+            } else if (group.field() == 2) {
+                // DenseNodes: parallel delta-coded arrays
+                result.ids.clear();
+                result.lats.clear();
+                result.lons.clear();
+                ProtoReader dense = group.bytes();
+                while (dense.next()) {
+                    switch (dense.field()) {
+                    case 1: dense.appendSignedVarints(result.ids); break;
+                    case 8: dense.appendSignedVarints(result.lats); break;
+                    case 9: dense.appendSignedVarints(result.lons); break;
+                    default: dense.skip(); break;
+                    }
+                }
+                if (result.lats.size() != result.ids.size() || result.lons.size() != result.ids.size()) {
+                    throw OsmFormatException("Corrupt PBF block: dense node arrays differ in length");
+                }
+                int64_t id = 0, lat = 0, lon = 0;
+                for (size_t i = 0; i < result.ids.size(); ++i) {
+                    id += result.ids[i];
+                    lat += result.lats[i];
+                    lon += result.lons[i];
+                    table.store(id, block.latitude(lat), block.longitude(lon));
+                }
+                result.nodesScanned += result.ids.size();
+            } else {
+                group.skip();
+            }
+        }
+    }
+}
+
+/**
+ * @class PbfFileReader
+ * @brief Reads the blob sequence of a PBF file
+ *
+ * The OSMHeader blob is checked for unsupported required features;
+ * OSMData blobs are numbered and handed out in batches.
+ */
+class PbfFileReader {
+private:
+    std::ifstream in_;
+    std::string path_;
+    size_t dataIndex_;
+    std::vector<unsigned char> header_;
+
+    uint32_t readLength(bool& atEnd) {
+        unsigned char bytes[4];
+        in_.read(reinterpret_cast<char*>(bytes), 4);
+        if (in_.gcount() == 0 && in_.eof()) {
+            atEnd = true;
+            return 0;
+        }
+        if (in_.gcount() != 4) {
+            throw OsmFormatException("Truncated PBF file: " + path_);
+        }
+        atEnd = false;
+        return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+               (static_cast<uint32_t>(bytes[2]) << 8) | bytes[3];
+    }
+
+    void readExactly(std::vector<unsigned char>& out, size_t size) {
+        out.resize(size);
+        in_.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(size));
+        if (static_cast<size_t>(in_.gcount()) != size) {
+            throw OsmFormatException("Truncated PBF file: " + path_);
+        }
+    }
+
+    void checkHeaderBlock(const std::vector<unsigned char>& blob) {
+        std::vector<unsigned char> data;
+        decompressBlob(blob, data);
+        ProtoReader reader(data.data(), data.size());
+        while (reader.next()) {
+            if (reader.field() != 4) {
+                reader.skip();
+                continue;
+            }
+            ProtoReader feature = reader.bytes();
+            std::string name(reinterpret_cast<const char*>(feature.data()), feature.size());
+            if (name != "OsmSchema-V0.6" && name != "DenseNodes") {
+                throw OsmFormatException("PBF file requires unsupported feature '" + name + "'");
+            }
+        }
+    }
+
+public:
+    explicit PbfFileReader(const std::string& path)
+        : in_(path.c_str(), std::ios::binary), path_(path), dataIndex_(0) {
+        if (!in_) {
+            throw OsmFormatException("Cannot open OSM file: " + path);
+        }
+    }
+
+    /**
+     * @brief Read up to batch.size() data blobs
+     * @param wanted If not null, blobs whose index maps to 0 are skipped unread
+     * @return Number of blobs filled; 0 at end of file
+     */
+    size_t readBatch(std::vector<PbfBlob*>& batch, const std::vector<uint8_t>* wanted) {
+        size_t filled = 0;
+        while (filled < batch.size()) {
+            bool atEnd = false;
+            uint32_t headerSize = readLength(atEnd);
+            if (atEnd) break;
+            if (headerSize > MAX_BLOB_HEADER_SIZE) {
+                throw OsmFormatException("Corrupt PBF file (blob header too large): " + path_);
+            }
+            readExactly(header_, headerSize);
+
+            std::string type;
+            uint64_t dataSize = 0;
+            ProtoReader reader(header_.data(), header_.size());
+            while (reader.next()) {
+                if (reader.field() == 1) {
+                    ProtoReader s = reader.bytes();
+                    type.assign(reinterpret_cast<const char*>(s.data()), s.size());
+                } else if (reader.field() == 3) {
+                    dataSize = reader.varint();
+                } else {
+                    reader.skip();
+                }
+            }
+            if (dataSize > MAX_BLOB_SIZE) {
+                throw OsmFormatException("Corrupt PBF file (blob too large): " + path_);
+            }
+
+            if (type == "OSMHeader") {
+                std::vector<unsigned char> blob;
+                readExactly(blob, static_cast<size_t>(dataSize));
+                checkHeaderBlock(blob);
+            } else if (type == "OSMData") {
+                size_t index = dataIndex_++;
+                if (wanted != nullptr && index < wanted->size() && !(*wanted)[index]) {
+                    in_.seekg(static_cast<std::streamoff>(dataSize), std::ios::cur);
+                    continue;
+                }
+                PbfBlob& blob = *batch[filled++];
+                blob.index = index;
+                readExactly(blob.raw, static_cast<size_t>(dataSize));
+            } else {
+                // Unknown blob types are skipped, as the format requires
+                in_.seekg(static_cast<std::streamoff>(dataSize), std::ios::cur);
+            }
+        }
+        return filled;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// XML
+// ---------------------------------------------------------------------------
+
+/**
+ * @class XmlTagReader
+ * @brief Pull reader returning one start / end tag at a time
+ *
+ * Only what OSM files use is understood: elements with quoted
+ * attributes, the five predefined entities and numeric character
+ * references. Text content, comments, processing instructions and
+ * DOCTYPE declarations are skipped.
+ */
+class XmlTagReader {
+private:
+    std::istream& in_;
+    std::vector<char> buffer_;
+    size_t pos_;
+    size_t end_;
+    size_t line_;
+
+    int peek() {
+        if (pos_ == end_) {
+            if (!in_) return EOF;
+            in_.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            end_ = static_cast<size_t>(in_.gcount());
+            pos_ = 0;
+            if (end_ == 0) return EOF;
+        }
+        return static_cast<unsigned char>(buffer_[pos_]);
+    }
+
+    int get() {
+        int c = peek();
+        if (c != EOF) {
+            ++pos_;
+            if (c == '\n') ++line_;
+        }
+        return c;
+    }
+
+    OsmFormatException error(const std::string& message) const {
+        return OsmFormatException("OSM XML line " + std::to_string(line_) + ": " + message);
+    }
+
+    // Skip until the given terminator has been consumed
+    void skipPast(const char* terminator) {
+        size_t length = std::strlen(terminator);
+        size_t matched = 0;
+        while (matched < length) {
+            int c = get();
+            if (c == EOF) throw error("unterminated markup");
+            if (c == terminator[matched]) {
+                ++matched;
+            } else {
+                matched = (c == terminator[0]) ? 1 : 0;
+            }
+        }
+    }
+
+    void skipSpace() {
+        while (std::isspace(peek())) get();
+    }
+
+    void appendEntity(std::string& out) {
+        std::string entity;
+        int c;
+        while ((c = get()) != ';') {
+            if (c == EOF || entity.size() > 10) throw error("unterminated entity");
+            entity.push_back(static_cast<char>(c));
+        }
+        if (entity == "amp") out.push_back('&');
+        else if (entity == "lt") out.push_back('<');
+        else if (entity == "gt") out.push_back('>');
+        else if (entity == "quot") out.push_back('"');
+        else if (entity == "apos") out.push_back('\'');
+        else if (!entity.empty() && entity[0] == '#') {
+            unsigned long code = (entity.size() > 1 && (entity[1] == 'x' || entity[1] == 'X'))
+                ? std::strtoul(entity.c_str() + 2, nullptr, 16)
+                : std::strtoul(entity.c_str() + 1, nullptr, 10);
+            // UTF-8 encode
+            if (code < 0x80) {
+                out.push_back(static_cast<char>(code));
+            } else if (code < 0x800) {
+                out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            } else if (code < 0x10000) {
+                out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            } else {
+                out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+        } else {
+            throw error("unknown entity &" + entity + ";");
+        }
+    }
+
+public:
+    std::string name;                                           ///< Element name
+    bool closing;                                               ///< </name>
+    bool selfClosing;                                           ///< <name ... />
+    std::vector<std::pair<std::string, std::string>> attributes;
+    size_t attributeCount;
+
+    explicit XmlTagReader(std::istream& in)
+        : in_(in), buffer_(XML_BUFFER_SIZE), pos_(0), end_(0), line_(1),
+          closing(false), selfClosing(false), attributeCount(0) {}
+
+    /**
+     * @brief Advance to the next element tag
+     * @return False at end of input
+     */
+    bool next() {
+        while (true) {
+            int c;
+            while ((c = get()) != '<') {
+                if (c == EOF) return false;
+            }
+            c = peek();
+            if (c == '?') {
+                skipPast("?>");
+                continue;
+            }
+            if (c == '!') {
+                get();
+                if (peek() == '-') {
+                    skipPast("-->");
+                } else if (peek() == '[') {
+                    skipPast("]]>");
+                } else {
+                    skipPast(">");
+                }
+                continue;
+            }
+            break;
+        }
+
+        closing = false;
+        selfClosing = false;
+        attributeCount = 0;
+        name.clear();
+        if (peek() == '/') {
+            get();
+            closing = true;
+        }
+        int c;
+        while ((c = peek()) != EOF && !std::isspace(c) && c != '>' && c != '/') {
+            name.push_back(static_cast<char>(get()));
+        }
+        while (true) {
+            skipSpace();
+            c = get();
+            if (c == '>') return true;
+            if (c == '/') {
+                if (get() != '>') throw error("expected '>' after '/'");
+                selfClosing = true;
+                return true;
+            }
+            if (c == EOF) throw error("unterminated tag <" + name);
+
+            // attribute name="value"
+            if (attributes.size() <= attributeCount) {
+                attributes.push_back(std::make_pair(std::string(), std::string()));
+            }
+            std::pair<std::string, std::string>& attribute = attributes[attributeCount++];
+            attribute.first.assign(1, static_cast<char>(c));
+            while ((c = peek()) != EOF && c != '=' && !std::isspace(c) && c != '>' && c != '/') {
+                attribute.first.push_back(static_cast<char>(get()));
+            }
+            skipSpace();
+            if (get() != '=') throw error("expected '=' after attribute " + attribute.first);
+            skipSpace();
+            int quote = get();
+            if (quote != '"' && quote != '\'') throw error("attribute value must be quoted");
+            attribute.second.clear();
+            while ((c = get()) != quote) {
+                if (c == EOF) throw error("unterminated attribute value");
+                if (c == '&') {
+                    appendEntity(attribute.second);
+                } else {
+                    attribute.second.push_back(static_cast<char>(c));
+                }
+            }
+        }
+    }
+
+    const std::string* attribute(const char* key) const {
+        for (size_t i = 0; i < attributeCount; ++i) {
+            if (attributes[i].first == key) return &attributes[i].second;
+        }
+        return nullptr;
+    }
+
+    size_t line() const {
+        return line_;
+    }
+};
+
+bool parseInt64(const std::string* text, int64_t& value) {
+    if (text == nullptr || text->empty()) return false;
+    char* end = nullptr;
+    value = std::strtoll(text->c_str(), &end, 10);
+    return *end == '\0';
+}
+
+bool parseCoordinate(const std::string* text, double& value) {
+    if (text == nullptr || text->empty()) return false;
+    char* end = nullptr;
+    value = std::strtod(text->c_str(), &end);
+    return *end == '\0';
+}
+
+// XML pass 1: kept ways
+void readXmlWays(const std::string& path, const OsmImportOptions& options,
+                 KeptWays& ways, OsmImportReport& report) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) throw OsmFormatException("Cannot open OSM file: " + path);
+    XmlTagReader tag(in);
+    WayTags tags;
+    std::vector<int64_t> refs;
+    bool inWay = false;
+    while (tag.next()) {
+        if (tag.name == "way") {
+            if (!tag.closing) {
+                ++report.waysScanned;
+                tags.clear();
+                refs.clear();
+                inWay = !tag.selfClosing;
+                continue;
+            }
+            if (inWay && keepWay(tags, options)) {
+                ways.add(refs.data(), refs.size());
+            }
+            inWay = false;
+        } else if (inWay && tag.name == "nd" && !tag.closing) {
+            int64_t ref;
+            if (!parseInt64(tag.attribute("ref"), ref)) {
+                throw OsmFormatException("OSM XML line " + std::to_string(tag.line()) +
+                                         ": <nd> without a valid ref");
+            }
+            refs.push_back(ref);
+        } else if (inWay && tag.name == "tag" && !tag.closing) {
+            const std::string* key = tag.attribute("k");
+            const std::string* value = tag.attribute("v");
+            if (key != nullptr && value != nullptr) {
+                tags.set(key->data(), key->size(), value->data(), value->size());
+            }
+        }
+    }
+    if (in.bad()) throw OsmFormatException("Read error in OSM file: " + path);
+}
+
+// XML pass 2: coordinates of referenced nodes
+void readXmlNodes(const std::string& path, NodeTable& table, OsmImportReport& report) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) throw OsmFormatException("Cannot open OSM file: " + path);
+    XmlTagReader tag(in);
+    while (tag.next()) {
+        if (tag.closing || tag.name != "node") continue;
+        ++report.nodesScanned;
+        int64_t id;
+        double lat, lon;
+        if (parseInt64(tag.attribute("id"), id) && parseCoordinate(tag.attribute("lat"), lat) &&
+            parseCoordinate(tag.attribute("lon"), lon)) {
+            table.store(id, lat, lon);
+        }
+    }
+    if (in.bad()) throw OsmFormatException("Read error in OSM file: " + path);
+}
+
+// ---------------------------------------------------------------------------
+// PBF passes
+// ---------------------------------------------------------------------------
+
+// PBF pass 1: kept ways, merged in file order
+void readPbfWays(const std::string& path, const OsmImportOptions& options, ThreadPool& pool,
+                 KeptWays& ways, std::vector<uint8_t>& blobHasNodes, OsmImportReport& report) {
+    PbfFileReader reader(path);
+    std::vector<WayBlockResult> results(pool.size() * 2);
+    std::vector<PbfBlob*> batch;
+    for (WayBlockResult& result : results) {
+        batch.push_back(&result.blob);
+    }
+    size_t count;
+    while ((count = reader.readBatch(batch, nullptr)) > 0) {
+        pool.parallelFor(count, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                decodeWays(results[i], options);
+            }
+        }, 1);
+        for (size_t i = 0; i < count; ++i) {
+            const WayBlockResult& result = results[i];
+            size_t base = ways.refs.size();
+            ways.refs.insert(ways.refs.end(), result.ways.refs.begin(), result.ways.refs.end());
+            for (size_t end : result.ways.ends) {
+                ways.ends.push_back(base + end);
+            }
+            report.waysScanned += result.waysScanned;
+            if (blobHasNodes.size() <= result.blob.index) {
+                blobHasNodes.resize(result.blob.index + 1, 0);
+            }
+            blobHasNodes[result.blob.index] = result.hasNodes ? 1 : 0;
+            ++report.blocks;
+        }
+    }
+}
+
+// PBF pass 2: node coordinates; blocks without nodes are not read again
+void readPbfNodes(const std::string& path, ThreadPool& pool, const std::vector<uint8_t>& blobHasNodes,
+                  NodeTable& table, OsmImportReport& report) {
+    PbfFileReader reader(path);
+    std::vector<NodeBlockResult> results(pool.size() * 2);
+    std::vector<PbfBlob*> batch;
+    for (NodeBlockResult& result : results) {
+        batch.push_back(&result.blob);
+    }
+    size_t count;
+    while ((count = reader.readBatch(batch, &blobHasNodes)) > 0) {
+        pool.parallelFor(count, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                decodeNodes(results[i], table);
+            }
+        }, 1);
+        for (size_t i = 0; i < count; ++i) {
+            report.nodesScanned += results[i].nodesScanned;
+        }
+    }
+}
+
+bool looksLikePbf(const std::string& path) {
+    std::string lower;
+    for (char c : path) lower.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    if (lower.size() >= 4 && lower.compare(lower.size() - 4, 4, ".pbf") == 0) return true;
+    if (lower.size() >= 4 && lower.compare(lower.size() - 4, 4, ".osm") == 0) return false;
+    // A PBF file starts with the big-endian size of a small blob header
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in) throw OsmFormatException("Cannot open OSM file: " + path);
+    unsigned char bytes[4] = { 0, 0, 0, 0 };
+    in.read(reinterpret_cast<char*>(bytes), 4);
+    return in.gcount() == 4 && bytes[0] == 0 && bytes[1] == 0;
+}
+
+// Union-find root with path halving
+uint32_t findRoot(std::vector<uint32_t>& parent, uint32_t node) {
+    while (parent[node] != node) {
+        parent[node] = parent[parent[node]];
+        node = parent[node];
+    }
+    return node;
+}
+
+} // namespace
+
+// Import an OSM extract
+OsmImportReport OsmImporter::importFile(const std::string& path, OsmNetwork& network,
+                                        const OsmImportOptions& options, Format format) {
+    OsmImportReport report;
+    if (format == Format::Auto) {
+        format = looksLikePbf(path) ? Format::Pbf : Format::Xml;
+    }
+    std::unique_ptr<ThreadPool> pool;
+    if (format == Format::Pbf) {
+        pool.reset(new ThreadPool(options.threads));
+    }
+
+    // Pass 1: ways
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    KeptWays ways;
+    std::vector<uint8_t> blobHasNodes;
+    if (format == Format::Pbf) {
+        readPbfWays(path, options, *pool, ways, blobHasNodes, report);
+    } else {
+        readXmlWays(path, options, ways, report);
+    }
+    report.waysKept = ways.ends.size();
+
+    // Distinct referenced nodes; a node used twice (by two ways, or twice
+    // by one way) is a junction
+    NodeTable table;
+    std::vector<uint8_t> routing;
+    {
+        std::vector<int64_t> sorted(ways.refs);
+        std::sort(sorted.begin(), sorted.end());
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            if (i > 0 && sorted[i] == sorted[i - 1]) {
+                routing.back() = 1;
+                continue;
+            }
+            table.ids.push_back(sorted[i]);
+            routing.push_back(options.keepShapeNodes ? 1 : 0);
+        }
+    }
+    report.referencedNodes = table.ids.size();
+    table.reset();
+
+    // Way refs as dense node indices
+    std::vector<uint32_t> wayNodes(ways.refs.size());
+    {
+        const std::vector<int64_t>& ids = table.ids;
+        const std::vector<int64_t>& refs = ways.refs;
+        auto translate = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                wayNodes[i] = static_cast<uint32_t>(
+                    std::lower_bound(ids.begin(), ids.end(), refs[i]) - ids.begin());
+            }
+        };
+        if (pool) {
+            pool->parallelFor(refs.size(), translate);
+        } else {
+            translate(0, refs.size());
+        }
+    }
+    std::vector<int64_t>().swap(ways.refs);
+
+    // Way ends are routing nodes; so is the far point of a closed way, so
+    // that a loop with a single junction is not lost as a self-loop
+    for (size_t w = 0, begin = 0; w < ways.ends.size(); begin = ways.ends[w++]) {
+        size_t end = ways.ends[w];
+        routing[wayNodes[begin]] = 1;
+        routing[wayNodes[end - 1]] = 1;
+        if (wayNodes[begin] == wayNodes[end - 1]) {
+            routing[wayNodes[begin + (end - begin) / 2]] = 1;
+        }
+    }
+    report.wayPassMillis = millisSince(started);
+
+    // Pass 2: nodes
+    started = std::chrono::steady_clock::now();
+    if (format == Format::Pbf) {
+        readPbfNodes(path, *pool, blobHasNodes, table, report);
+    } else {
+        readXmlNodes(path, table, report);
+    }
+    for (const std::atomic<uint8_t>& found : table.found) {
+        if (!found.load()) ++report.missingNodes;
+    }
+    report.nodePassMillis = millisSince(started);
+
+    // Cut ways at routing nodes. A node missing from the extract ends the
+    // current piece at the last node that has coordinates.
+    started = std::chrono::steady_clock::now();
+    Location from, to;
+    std::vector<uint32_t> pieceNodes;       // (a, b) pairs of node indices
+    std::vector<double> pieceLengths;
+    for (size_t w = 0, begin = 0; w < ways.ends.size(); begin = ways.ends[w++]) {
+        uint32_t start = NO_NODE;
+        uint32_t previous = NO_NODE;
+        double length = 0.0;
+        for (size_t i = begin; i < ways.ends[w]; ++i) {
+            uint32_t node = wayNodes[i];
+            if (!table.found[node]) {
+                if (start != NO_NODE && previous != start) {
+                    pieceNodes.push_back(start);
+                    pieceNodes.push_back(previous);
+                    pieceLengths.push_back(length);
+                }
+                start = previous = NO_NODE;
+                continue;
+            }
+            if (start == NO_NODE) {
+                start = previous = node;
+                length = 0.0;
+                continue;
+            }
+            from.setLatitude(table.latitude[previous]);
+            from.setLongitude(table.longitude[previous]);
+            to.setLatitude(table.latitude[node]);
+            to.setLongitude(table.longitude[node]);
+            length += from.distanceTo(to);
+            previous = node;
+            if (routing[node]) {
+                if (node != start) {
+                    pieceNodes.push_back(start);
+                    pieceNodes.push_back(node);
+                    pieceLengths.push_back(length);
+                }
+                start = node;
+                length = 0.0;
+            }
+        }
+        if (start != NO_NODE && previous != start) {
+            pieceNodes.push_back(start);
+            pieceNodes.push_back(previous);
+            pieceLengths.push_back(length);
+        }
+    }
+    std::vector<uint32_t>().swap(wayNodes);
+
+    // Parallel pieces between the same two nodes: keep the shortest
+    std::vector<size_t> order(pieceLengths.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+        if (pieceNodes[2 * i] > pieceNodes[2 * i + 1]) {
+            std::swap(pieceNodes[2 * i], pieceNodes[2 * i + 1]);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (pieceNodes[2 * a] != pieceNodes[2 * b]) return pieceNodes[2 * a] < pieceNodes[2 * b];
+        if (pieceNodes[2 * a + 1] != pieceNodes[2 * b + 1]) return pieceNodes[2 * a + 1] < pieceNodes[2 * b + 1];
+        return pieceLengths[a] < pieceLengths[b];
+    });
+    std::vector<size_t> kept;
+    for (size_t k = 0; k < order.size(); ++k) {
+        size_t i = order[k];
+        if (k > 0) {
+            size_t p = order[k - 1];
+            if (pieceNodes[2 * i] == pieceNodes[2 * p] && pieceNodes[2 * i + 1] == pieceNodes[2 * p + 1]) {
+                continue;
+            }
+        }
+        kept.push_back(i);
+    }
+
+    // Dense location numbering for nodes that end a piece
+    std::vector<uint32_t> locationOf(table.ids.size(), NO_NODE);
+    std::vector<uint32_t> locationNode;
+    for (size_t i : kept) {
+        for (int side = 0; side < 2; ++side) {
+            uint32_t node = pieceNodes[2 * i + side];
+            if (locationOf[node] == NO_NODE) {
+                locationOf[node] = static_cast<uint32_t>(locationNode.size());
+                locationNode.push_back(node);
+            }
+        }
+    }
+
+    // Keep only the largest connected component
+    std::vector<uint8_t> keepLocation(locationNode.size(), 1);
+    if (options.largestComponentOnly && !locationNode.empty()) {
+        std::vector<uint32_t> parent(locationNode.size());
+        for (uint32_t i = 0; i < parent.size(); ++i) parent[i] = i;
+        for (size_t i : kept) {
+            uint32_t a = findRoot(parent, locationOf[pieceNodes[2 * i]]);
+            uint32_t b = findRoot(parent, locationOf[pieceNodes[2 * i + 1]]);
+            if (a != b) parent[a] = b;
+        }
+        std::vector<uint32_t> size(parent.size(), 0);
+        uint32_t largest = 0;
+        for (uint32_t i = 0; i < parent.size(); ++i) {
+            uint32_t root = findRoot(parent, i);
+            if (++size[root] > size[largest]) largest = root;
+        }
+        for (uint32_t i = 0; i < parent.size(); ++i) {
+            if (findRoot(parent, i) != largest) {
+                keepLocation[i] = 0;
+                ++report.droppedLocations;
+            }
+        }
+    }
+
+    // Materialise Locations and connections
+    for (Location* loc : network.locations) {
+        delete loc;
+    }
+    network.locations.clear();
+    network.connections.clear();
+    network.distances.clear();
+    std::vector<int> finalIndex(locationNode.size(), -1);
+    for (uint32_t i = 0; i < locationNode.size(); ++i) {
+        if (!keepLocation[i]) continue;
+        uint32_t node = locationNode[i];
+        finalIndex[i] = static_cast<int>(network.locations.size());
+        network.locations.push_back(new Location(
+            "osm_" + std::to_string(table.ids[node]), table.latitude[node], table.longitude[node],
+            "[hidden]", finalIndex[i]));
+    }
+    for (size_t i : kept) {
+        int a = finalIndex[locationOf[pieceNodes[2 * i]]];
+        int b = finalIndex[locationOf[pieceNodes[2 * i + 1]]];
+        if (a < 0 || b < 0) continue;
+        network.connections.push_back(std::make_pair(a, b));
+        network.distances.push_back(pieceLengths[i]);
+    }
+    report.buildMillis = millisSince(started);
+    return report;
+}
+
+// Whether this build links zlib
+bool OsmImporter::hasZlibSupport() {
+#ifdef CAMPUS_NAV_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
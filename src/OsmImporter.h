@@ -0,0 +1,154 @@
+/**
+ * @file OsmImporter.h
+ * @brief Streaming importer for OpenStreetMap XML (.osm) and PBF (.osm.pbf) extracts.
+ *
+ * Turns the footpath / street network of a local OSM extract into the
+ * locations, connections and distances taken by Navigator::initializeGraph,
+ * so the routing engine can be exercised on city-sized graphs instead of
+ * the built-in campus. No network access is involved.
+ *
+ * The file is read twice, since OSM stores nodes before the ways that use
+ * them:
+ *
+ *   1. ways: keep those usable on foot or by bicycle and record their node
+ *      references; a node is routing-relevant if it ends a way or is shared
+ *      by several kept ways (a junction);
+ *   2. nodes: look up coordinates for referenced nodes only.
+ *
+ * Each kept way is then cut at its routing-relevant nodes. Every piece
+ * becomes one connection weighted by the sum of Location::distanceTo over
+ * its segments, so intermediate shape nodes never become Locations.
+ *
+ * PBF blocks are decompressed and decoded on a ThreadPool, a bounded batch
+ * of blocks at a time. zlib-compressed blocks (the common case) need the
+ * build to define CAMPUS_NAV_HAVE_ZLIB and link zlib; uncompressed blocks
+ * always work. XML is parsed on the calling thread.
+ */
+
+#ifndef OSM_IMPORTER_H
+#define OSM_IMPORTER_H
+
+#include "Location.h"
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <cstddef>
+
+/**
+ * @class OsmFormatException
+ * @brief Thrown when an OSM file cannot be read or is malformed
+ */
+class OsmFormatException : public std::runtime_error {
+public:
+    explicit OsmFormatException(const std::string& message)
+        : std::runtime_error(message) {}
+};
+
+/**
+ * @struct OsmImportOptions
+ * @brief Which ways to keep and how to build the network
+ */
+struct OsmImportOptions {
+    bool walking;               ///< Keep ways usable on foot
+    bool cycling;               ///< Keep ways usable by bicycle
+    bool keepShapeNodes;        ///< Make every way node a Location (no collapsing)
+    bool largestComponentOnly;  ///< Drop islands not connected to the main network
+    unsigned threads;           ///< PBF decoding threads (0 = all hardware threads)
+
+    OsmImportOptions()
+        : walking(true), cycling(true), keepShapeNodes(false),
+          largestComponentOnly(true), threads(0) {}
+};
+
+/**
+ * @struct OsmImportReport
+ * @brief Counts and timings of one import
+ */
+struct OsmImportReport {
+    size_t blocks;              ///< PBF blocks decoded (0 for XML)
+    size_t nodesScanned;        ///< Nodes in the file
+    size_t waysScanned;         ///< Ways in the file
+    size_t waysKept;            ///< Walkable / cyclable ways
+    size_t referencedNodes;     ///< Distinct nodes used by kept ways
+    size_t missingNodes;        ///< Referenced nodes absent from the file (clipped extract)
+    size_t droppedLocations;    ///< Locations removed with smaller components
+    double wayPassMillis;       ///< Pass 1
+    double nodePassMillis;      ///< Pass 2
+    double buildMillis;         ///< Cutting ways into connections
+
+    OsmImportReport()
+        : blocks(0), nodesScanned(0), waysScanned(0), waysKept(0), referencedNodes(0),
+          missingNodes(0), droppedLocations(0), wayPassMillis(0.0), nodePassMillis(0.0),
+          buildMillis(0.0) {}
+};
+
+/**
+ * @struct OsmNetwork
+ * @brief Imported network in the form taken by Navigator::initializeGraph
+ *
+ * Owns the Locations. Location i is named "osm_<node id>", has id i and
+ * the description "[hidden]", like the campus turn nodes.
+ */
+struct OsmNetwork {
+    std::vector<Location*> locations;
+    std::vector<std::pair<int, int>> connections;   ///< Undirected, no duplicates
+    std::vector<double> distances;                  ///< Metres, one per connection
+
+    OsmNetwork() {}
+
+    ~OsmNetwork() {
+        for (Location* loc : locations) {
+            delete loc;
+        }
+    }
+
+    OsmNetwork(const OsmNetwork&) = delete;
+    OsmNetwork& operator=(const OsmNetwork&) = delete;
+};
+
+/**
+ * @class OsmImporter
+ * @brief Reads walkable / cyclable ways from an OSM extract
+ *
+ * Example usage:
+ * @code
+ * OsmNetwork network;
+ * OsmImportReport report = OsmImporter::importFile("city.osm.pbf", network);
+ * Navigator navigator;
+ * navigator.initializeGraph(network.locations, network.connections, network.distances);
+ * @endcode
+ */
+class OsmImporter {
+public:
+    /**
+     * @enum Format
+     * @brief Input format
+     */
+    enum class Format {
+        Auto,       ///< ".pbf" extension or binary content means PBF, else XML
+        Xml,
+        Pbf
+    };
+
+    /**
+     * @brief Import an OSM file
+     * @param path Input file
+     * @param network Output: replaced by the imported network
+     * @param options Way filter and build options
+     * @param format Input format
+     * @return Counts and timings
+     * @throws OsmFormatException if the file cannot be read, is malformed,
+     *         or uses a PBF feature or compression this build cannot decode
+     */
+    static OsmImportReport importFile(const std::string& path, OsmNetwork& network,
+                                      const OsmImportOptions& options = OsmImportOptions(),
+                                      Format format = Format::Auto);
+
+    /**
+     * @brief Whether zlib-compressed PBF blocks can be decoded
+     */
+    static bool hasZlibSupport();
+};
+
+#endif // OSM_IMPORTER_H
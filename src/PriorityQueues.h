@@ -0,0 +1,406 @@
+/**
+ * @file PriorityQueues.h
+ * @brief Interchangeable priority queues for label-setting searches.
+ *
+ * Every queue orders dense node indices by a double key and offers the
+ * same small interface, so a search can take the queue as a template
+ * policy:
+ *
+ * - clear(nodeCount): empty the queue before a query (cost proportional to
+ *   what the previous query left behind, not to nodeCount);
+ * - push(key, node): insert, or lower the key of a node already queued
+ *   (queues without decrease-key store a second entry instead);
+ * - pop(): remove and return the minimum (key, node);
+ * - empty();
+ * - capacity(): entries the buffers can hold without reallocating, so a
+ *   search can tell whether a query grew them.
+ *
+ * Queues without decrease-key leave stale entries behind, so the search
+ * must skip nodes that are already settled. That check is harmless for
+ * the indexed queues.
+ *
+ * Like SearchWorkspace, a queue keeps its buffers between queries and is
+ * not thread-safe; use one per thread.
+ */
+
+#ifndef PRIORITY_QUEUES_H
+#define PRIORITY_QUEUES_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+/**
+ * @class BinaryHeapQueue
+ * @brief std::push_heap/pop_heap binary heap with lazy deletion
+ *
+ * Simple and cache-friendly; decrease-key pushes a duplicate entry.
+ */
+class BinaryHeapQueue {
+public:
+    typedef std::pair<double, uint32_t> Entry;
+
+private:
+    std::vector<Entry> heap_;   ///< Min-heap under std::greater
+
+public:
+    void clear(size_t) {
+        heap_.clear();
+    }
+
+    void push(double key, uint32_t node) {
+        heap_.push_back(Entry(key, node));
+        std::push_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+    }
+
+    Entry pop() {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+        Entry top = heap_.back();
+        heap_.pop_back();
+        return top;
+    }
+
+    bool empty() const {
+        return heap_.empty();
+    }
+
+    size_t capacity() const {
+        return heap_.capacity();
+    }
+};
+
+/**
+ * @class QuaternaryHeapQueue
+ * @brief 4-ary heap with a node -> slot index and true decrease-key
+ *
+ * Each node is queued at most once, so the heap never grows past the
+ * frontier. The wider fan-out halves the tree height compared with a
+ * binary heap, and the four children of a slot share a cache line.
+ */
+class QuaternaryHeapQueue {
+public:
+    typedef std::pair<double, uint32_t> Entry;
+
+private:
+    static const uint32_t NOT_QUEUED = 0xFFFFFFFFu;
+
+    std::vector<Entry> heap_;           ///< Slot 0 is the minimum
+    std::vector<uint32_t> position_;    ///< Slot of each queued node, else NOT_QUEUED
+
+    void place(size_t slot, const Entry& entry) {
+        heap_[slot] = entry;
+        position_[entry.second] = static_cast<uint32_t>(slot);
+    }
+
+    void siftUp(size_t slot) {
+        Entry entry = heap_[slot];
+        while (slot > 0) {
+            size_t parent = (slot - 1) / 4;
+            if (!(entry.first < heap_[parent].first)) {
+                break;
+            }
+            place(slot, heap_[parent]);
+            slot = parent;
+        }
+        place(slot, entry);
+    }
+
+    void siftDown(size_t slot) {
+        Entry entry = heap_[slot];
+        const size_t size = heap_.size();
+        while (true) {
+            size_t first = 4 * slot + 1;
+            if (first >= size) {
+                break;
+            }
+            size_t best = first;
+            size_t last = std::min(first + 4, size);
+            for (size_t child = first + 1; child < last; ++child) {
+                if (heap_[child].first < heap_[best].first) {
+                    best = child;
+                }
+            }
+            if (!(heap_[best].first < entry.first)) {
+                break;
+            }
+            place(slot, heap_[best]);
+            slot = best;
+        }
+        place(slot, entry);
+    }
+
+public:
+    void clear(size_t nodeCount) {
+        for (const Entry& entry : heap_) {
+            position_[entry.second] = NOT_QUEUED;
+        }
+        heap_.clear();
+        if (position_.size() < nodeCount) {
+            position_.resize(nodeCount, static_cast<uint32_t>(NOT_QUEUED));
+        }
+    }
+
+    void push(double key, uint32_t node) {
+        uint32_t slot = position_[node];
+        if (slot == NOT_QUEUED) {
+            heap_.push_back(Entry(key, node));
+            siftUp(heap_.size() - 1);
+        } else if (key < heap_[slot].first) {
+            heap_[slot].first = key;
+            siftUp(slot);
+        }
+    }
+
+    Entry pop() {
+        Entry top = heap_.front();
+        position_[top.second] = NOT_QUEUED;
+        Entry last = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty()) {
+            place(0, last);
+            siftDown(0);
+        }
+        return top;
+    }
+
+    bool empty() const {
+        return heap_.empty();
+    }
+
+    size_t capacity() const {
+        return heap_.capacity() + position_.capacity();
+    }
+};
+
+/**
+ * @class PairingHeapQueue
+ * @brief Pairing heap over per-node link arrays, with decrease-key
+ *
+ * Insert and decrease-key are O(1) (a single link with the root); pop
+ * merges the root's children with the standard two-pass pairing. Nodes
+ * are threaded through index arrays rather than allocated, and queue
+ * membership is stamped with an epoch so clear() is O(1).
+ */
+class PairingHeapQueue {
+public:
+    typedef std::pair<double, uint32_t> Entry;
+
+private:
+    static const uint32_t NONE = 0xFFFFFFFFu;
+
+    std::vector<double> key_;
+    std::vector<uint32_t> child_;       ///< Leftmost child
+    std::vector<uint32_t> sibling_;     ///< Next sibling to the right
+    std::vector<uint32_t> prev_;        ///< Left sibling, or parent for a leftmost child
+    std::vector<uint32_t> stamp_;       ///< Epoch in which the node is queued
+    std::vector<uint32_t> pairs_;       ///< Scratch list of children during pop
+    uint32_t epoch_;
+    uint32_t root_;
+
+    // Make the larger-key root a child of the smaller one
+    uint32_t link(uint32_t a, uint32_t b) {
+        if (key_[b] < key_[a]) {
+            std::swap(a, b);
+        }
+        sibling_[b] = child_[a];
+        if (child_[a] != NONE) {
+            prev_[child_[a]] = b;
+        }
+        prev_[b] = a;
+        child_[a] = b;
+        return a;
+    }
+
+    // Unhook a non-root node (with its subtree) from its parent/siblings
+    void detach(uint32_t node) {
+        uint32_t before = prev_[node];
+        if (child_[before] == node) {
+            child_[before] = sibling_[node];
+        } else {
+            sibling_[before] = sibling_[node];
+        }
+        if (sibling_[node] != NONE) {
+            prev_[sibling_[node]] = before;
+        }
+        sibling_[node] = NONE;
+        prev_[node] = NONE;
+    }
+
+public:
+    PairingHeapQueue() : epoch_(0), root_(NONE) {}
+
+    void clear(size_t nodeCount) {
+        root_ = NONE;
+        if (stamp_.size() < nodeCount) {
+            key_.resize(nodeCount);
+            child_.resize(nodeCount);
+            sibling_.resize(nodeCount);
+            prev_.resize(nodeCount);
+            stamp_.resize(nodeCount, 0);
+        }
+        if (++epoch_ == 0) {
+            std::fill(stamp_.begin(), stamp_.end(), 0u);
+            epoch_ = 1;
+        }
+    }
+
+    void push(double key, uint32_t node) {
+        if (stamp_[node] != epoch_) {
+            stamp_[node] = epoch_;
+            key_[node] = key;
+            child_[node] = sibling_[node] = prev_[node] = NONE;
+            root_ = (root_ == NONE) ? node : link(root_, node);
+        } else if (key < key_[node]) {
+            key_[node] = key;
+            if (node != root_) {
+                detach(node);
+                root_ = link(root_, node);
+            }
+        }
+    }
+
+    Entry pop() {
+        uint32_t top = root_;
+        stamp_[top] = 0;
+
+        // First pass: link children pairwise from the left
+        pairs_.clear();
+        uint32_t next = child_[top];
+        while (next != NONE) {
+            uint32_t a = next;
+            uint32_t b = sibling_[a];
+            next = (b != NONE) ? sibling_[b] : NONE;
+            sibling_[a] = prev_[a] = NONE;
+            if (b != NONE) {
+                sibling_[b] = prev_[b] = NONE;
+                a = link(a, b);
+            }
+            pairs_.push_back(a);
+        }
+
+        // Second pass: fold the pairs from the right
+        root_ = NONE;
+        for (size_t i = pairs_.size(); i-- > 0; ) {
+            root_ = (root_ == NONE) ? pairs_[i] : link(pairs_[i], root_);
+        }
+        return Entry(key_[top], top);
+    }
+
+    bool empty() const {
+        return root_ == NONE;
+    }
+
+    size_t capacity() const {
+        return key_.capacity() + child_.capacity() + sibling_.capacity() +
+               prev_.capacity() + stamp_.capacity() + pairs_.capacity();
+    }
+};
+
+/**
+ * @class RadixHeapQueue
+ * @brief Monotone radix heap keyed on the bit pattern of the distance
+ *
+ * Non-negative IEEE doubles compare like their 64-bit patterns, so the
+ * integer radix heap applies to metre distances without rounding. Bucket
+ * i holds keys whose highest bit differing from the last popped key is
+ * bit i - 1; popping redistributes one bucket into lower ones, so each
+ * entry moves at most 64 times. Requires monotone keys (Dijkstra never
+ * pushes below the last popped key); a smaller key is clamped to it.
+ * Decrease-key pushes a duplicate entry.
+ */
+class RadixHeapQueue {
+public:
+    typedef std::pair<double, uint32_t> Entry;
+
+private:
+    struct Item {
+        uint64_t bits;
+        double key;
+        uint32_t node;
+    };
+
+    std::vector<Item> buckets_[65];
+    uint64_t last_;     ///< Bit pattern of the last popped key
+    size_t size_;
+
+    static uint64_t toBits(double key) {
+        uint64_t bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        return bits;
+    }
+
+    size_t bucketOf(uint64_t bits) const {
+        uint64_t diff = bits ^ last_;
+        if (diff == 0) {
+            return 0;
+        }
+#if defined(__GNUC__) || defined(__clang__)
+        return 64 - static_cast<size_t>(__builtin_clzll(diff));
+#else
+        size_t bucket = 0;
+        while (diff != 0) {
+            diff >>= 1;
+            ++bucket;
+        }
+        return bucket;
+#endif
+    }
+
+public:
+    RadixHeapQueue() : last_(0), size_(0) {}
+
+    void clear(size_t) {
+        for (std::vector<Item>& bucket : buckets_) {
+            bucket.clear();
+        }
+        last_ = 0;
+        size_ = 0;
+    }
+
+    void push(double key, uint32_t node) {
+        Item item = { std::max(toBits(key), last_), key, node };
+        buckets_[bucketOf(item.bits)].push_back(item);
+        ++size_;
+    }
+
+    Entry pop() {
+        if (buckets_[0].empty()) {
+            size_t i = 1;
+            while (buckets_[i].empty()) {
+                ++i;
+            }
+            std::vector<Item>& source = buckets_[i];
+            uint64_t smallest = source.front().bits;
+            for (const Item& item : source) {
+                smallest = std::min(smallest, item.bits);
+            }
+            last_ = smallest;
+            for (const Item& item : source) {
+                buckets_[bucketOf(item.bits)].push_back(item);
+            }
+            source.clear();
+        }
+        Item item = buckets_[0].back();
+        buckets_[0].pop_back();
+        --size_;
+        return Entry(item.key, item.node);
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    size_t capacity() const {
+        size_t total = 0;
+        for (const std::vector<Item>& bucket : buckets_) {
+            total += bucket.capacity();
+        }
+        return total;
+    }
+};
+
+#endif // PRIORITY_QUEUES_H
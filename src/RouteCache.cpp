@@ -0,0 +1,155 @@
+/**
+ * @file RouteCache.cpp
+ * @brief Implementation of the sharded LRU RouteCache.
+ */
+
+#include "RouteCache.h"
+#include <functional>
+
+// Combine every key field into one hash
+size_t RouteKeyHash::operator()(const RouteKey& key) const {
+    size_t h = std::hash<int>()(key.start);
+    auto mix = [&h](size_t value) {
+        h ^= value + 0x9e3779b9 + (h << 6) + (h >> 2);
+    };
+    mix(std::hash<int>()(key.end));
+    for (int via : key.vias) {
+        mix(std::hash<int>()(via));
+    }
+    mix(std::hash<std::string>()(key.mode));
+    mix(std::hash<int>()(key.engine));
+    return h;
+}
+
+// Constructor
+RouteCache::RouteCache(size_t capacity, size_t shards)
+    : shardCapacity_(0), hits_(0), misses_(0), evictions_(0), invalidations_(0), erased_(0) {
+    if (shards == 0) {
+        shards = 1;
+    }
+    if (capacity > 0) {
+        // Round up so the total is never below the requested capacity
+        shardCapacity_ = (capacity + shards - 1) / shards;
+    }
+    for (size_t i = 0; i < shards; ++i) {
+        shards_.push_back(std::unique_ptr<Shard>(new Shard()));
+    }
+}
+
+// Caching enabled?
+bool RouteCache::enabled() const {
+    return shardCapacity_ > 0;
+}
+
+// Pick the shard for a key; caller must lock it
+RouteCache::Shard& RouteCache::shardFor(const RouteKey& key) {
+    return *shards_[RouteKeyHash()(key) % shards_.size()];
+}
+
+// Drop a shard's entries if they belong to an older graph; caller holds the lock
+void RouteCache::syncVersion(Shard& shard, unsigned long long version) {
+    if (shard.version == version) {
+        return;
+    }
+    if (!shard.lru.empty()) {
+        ++invalidations_;
+    }
+    shard.lru.clear();
+    shard.index.clear();
+    shard.version = version;
+}
+
+// Lookup
+std::shared_ptr<const RouteResult> RouteCache::find(const RouteKey& key,
+                                                    unsigned long long version) {
+    if (!enabled()) {
+        return std::shared_ptr<const RouteResult>();
+    }
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    syncVersion(shard, version);
+
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        ++misses_;
+        return std::shared_ptr<const RouteResult>();
+    }
+
+    // Move to front (most recently used)
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    ++hits_;
+    return it->second->second;
+}
+
+// Insert
+void RouteCache::insert(const RouteKey& key, unsigned long long version,
+                        std::shared_ptr<const RouteResult> result) {
+    if (!enabled()) {
+        return;
+    }
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (version < shard.version) {
+        return;     // computed on a graph that has since changed
+    }
+    syncVersion(shard, version);
+
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        // Another thread computed the same route concurrently
+        it->second->second = result;
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return;
+    }
+
+    shard.lru.push_front(std::make_pair(key, result));
+    shard.index[key] = shard.lru.begin();
+    while (shard.lru.size() > shardCapacity_) {
+        shard.index.erase(shard.lru.back().first);
+        shard.lru.pop_back();
+        ++evictions_;
+    }
+}
+
+// Selective invalidation
+size_t RouteCache::eraseIf(const std::function<bool(const RouteKey&, const RouteResult&)>& predicate) {
+    size_t count = 0;
+    for (std::unique_ptr<Shard>& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (Shard::Lru::iterator it = shard->lru.begin(); it != shard->lru.end(); ) {
+            if (predicate(it->first, *it->second)) {
+                shard->index.erase(it->first);
+                it = shard->lru.erase(it);
+                ++count;
+            } else {
+                ++it;
+            }
+        }
+    }
+    erased_ += count;
+    return count;
+}
+
+// Drop everything
+void RouteCache::clear() {
+    for (std::unique_ptr<Shard>& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->lru.clear();
+        shard->index.clear();
+    }
+}
+
+// Counter snapshot
+RouteCacheStats RouteCache::getStats() const {
+    RouteCacheStats stats;
+    stats.hits = hits_.load();
+    stats.misses = misses_.load();
+    stats.evictions = evictions_.load();
+    stats.invalidations = invalidations_.load();
+    stats.erased = erased_.load();
+    for (const std::unique_ptr<Shard>& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        stats.entries += shard->lru.size();
+    }
+    return stats;
+}
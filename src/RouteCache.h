@@ -0,0 +1,161 @@
+/**
+ * @file RouteCache.h
+ * @brief Bounded, sharded LRU cache of route query results.
+ *
+ * The GUI and kiosk deployments ask for the same few start/end/via
+ * combinations again and again. Results are cached under the node ids of
+ * start, end and the ordered vias plus the navigation mode and search
+ * engine. The key space is split over independently locked shards so
+ * concurrent queries rarely contend. Every entry is tagged with the graph
+ * version it was computed for; a shard that sees a newer version drops its
+ * contents, so edits through Graph::addEdge/removeEdge/removeNode
+ * invalidate the cache automatically.
+ */
+
+#ifndef ROUTE_CACHE_H
+#define ROUTE_CACHE_H
+
+#include <list>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <functional>
+#include <cstddef>
+
+struct RouteResult;
+
+/**
+ * @struct RouteKey
+ * @brief Cache key: start, end, ordered vias, mode and engine
+ */
+struct RouteKey {
+    int start;                  ///< Start location id
+    int end;                    ///< End location id
+    std::vector<int> vias;      ///< Via location ids in visiting order
+    std::string mode;           ///< Navigation mode name
+    int engine;                 ///< Search engine
+
+    bool operator==(const RouteKey& other) const {
+        return start == other.start && end == other.end && engine == other.engine &&
+               vias == other.vias && mode == other.mode;
+    }
+};
+
+/**
+ * @struct RouteKeyHash
+ * @brief Hash functor for RouteKey
+ */
+struct RouteKeyHash {
+    size_t operator()(const RouteKey& key) const;
+};
+
+/**
+ * @struct RouteCacheStats
+ * @brief Counters exposed by RouteCache
+ */
+struct RouteCacheStats {
+    size_t hits;            ///< Lookups answered from the cache
+    size_t misses;          ///< Lookups that had to search
+    size_t evictions;       ///< Entries dropped by LRU
+    size_t invalidations;   ///< Shard flushes caused by graph changes
+    size_t erased;          ///< Entries dropped selectively by eraseIf()
+    size_t entries;         ///< Entries currently cached
+
+    RouteCacheStats()
+        : hits(0), misses(0), evictions(0), invalidations(0), erased(0), entries(0) {}
+};
+
+/**
+ * @class RouteCache
+ * @brief Thread-safe sharded LRU map RouteKey -> RouteResult
+ */
+class RouteCache {
+private:
+    /**
+     * @struct Shard
+     * @brief Independently locked LRU list + index
+     */
+    struct Shard {
+        typedef std::list<std::pair<RouteKey, std::shared_ptr<const RouteResult>>> Lru;
+
+        std::mutex mutex;
+        Lru lru;                                                    ///< Front = most recent
+        std::unordered_map<RouteKey, Lru::iterator, RouteKeyHash> index;
+        unsigned long long version;                                 ///< Graph version of contents
+
+        Shard() : version(0) {}
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;    ///< Key space partitions
+    size_t shardCapacity_;                          ///< Max entries per shard
+    std::atomic<size_t> hits_;
+    std::atomic<size_t> misses_;
+    std::atomic<size_t> evictions_;
+    std::atomic<size_t> invalidations_;
+    std::atomic<size_t> erased_;
+
+    /**
+     * @brief Select the shard owning a key
+     */
+    Shard& shardFor(const RouteKey& key);
+
+    /**
+     * @brief Flush a locked shard if it holds results of another graph version
+     */
+    void syncVersion(Shard& shard, unsigned long long version);
+
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Total entries (0 disables caching)
+     * @param shards Number of shards
+     */
+    explicit RouteCache(size_t capacity = 0, size_t shards = 16);
+
+    /**
+     * @brief Whether the cache stores anything
+     */
+    bool enabled() const;
+
+    /**
+     * @brief Look up a result
+     * @param key Query key
+     * @param version Current graph version
+     * @return Cached result, or null on miss
+     */
+    std::shared_ptr<const RouteResult> find(const RouteKey& key, unsigned long long version);
+
+    /**
+     * @brief Insert a result, evicting the least recently used entry if full
+     * @param key Query key
+     * @param version Graph version the result was computed on
+     * @param result Result to cache
+     */
+    void insert(const RouteKey& key, unsigned long long version,
+                std::shared_ptr<const RouteResult> result);
+
+    /**
+     * @brief Drop only the entries a predicate selects
+     * @param predicate Returns true for entries that are no longer valid
+     * @return Number of entries dropped
+     *
+     * Used for local changes such as a single closed edge, where most
+     * cached routes stay correct.
+     */
+    size_t eraseIf(const std::function<bool(const RouteKey&, const RouteResult&)>& predicate);
+
+    /**
+     * @brief Drop every entry
+     */
+    void clear();
+
+    /**
+     * @brief Snapshot of the counters
+     */
+    RouteCacheStats getStats() const;
+};
+
+#endif // ROUTE_CACHE_H
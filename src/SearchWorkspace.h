@@ -0,0 +1,219 @@
+/**
+ * @file SearchWorkspace.h
+ * @brief Reusable, allocation-free scratch state for shortest-path searches.
+ *
+ * A workspace owns the per-node arrays (distance, predecessor, settled flag)
+ * and the priority queue used by one search. Instead of resetting O(V)
+ * state on every query it stamps each slot with the epoch of the query that
+ * last wrote it; slots from older epochs read as "unreached". A query that
+ * settles 30 nodes therefore only touches those 30 nodes.
+ *
+ * Workspaces are not thread-safe; use one per thread and search direction
+ * (see Navigator::threadWorkspace()).
+ */
+
+#ifndef SEARCH_WORKSPACE_H
+#define SEARCH_WORKSPACE_H
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+/**
+ * @struct SearchStats
+ * @brief Counters describing the work done by one query
+ */
+struct SearchStats {
+    size_t nodesSettled;        ///< Nodes popped and finalized
+    size_t edgesRelaxed;        ///< Edges scanned
+    size_t allocations;         ///< Search buffer growths (workspace, queue) during the query
+
+    SearchStats() : nodesSettled(0), edgesRelaxed(0), allocations(0) {}
+};
+
+/**
+ * @class SearchWorkspace
+ * @brief Epoch-stamped distance/predecessor arrays plus a reusable heap
+ */
+class SearchWorkspace {
+public:
+    typedef std::pair<double, uint32_t> QueueEntry;
+
+    static const uint32_t NO_NODE = 0xFFFFFFFFu;
+
+private:
+    std::vector<double> distance_;      ///< Tentative distance (valid if stamp_ == epoch_)
+    std::vector<uint32_t> previous_;    ///< Predecessor index (valid if stamp_ == epoch_)
+    std::vector<uint32_t> stamp_;       ///< Epoch that last wrote distance_/previous_
+    std::vector<uint32_t> settled_;     ///< Epoch in which the node was settled
+    std::vector<QueueEntry> heap_;      ///< Binary min-heap storage, reused across queries
+    uint32_t epoch_;                    ///< Current query generation
+    size_t allocations_;                ///< Total buffer growths since construction
+    SearchStats stats_;                 ///< Counters for the current query
+
+    void growHeapIfFull() {
+        if (heap_.size() == heap_.capacity()) {
+            ++allocations_;
+            ++stats_.allocations;
+        }
+    }
+
+public:
+    /**
+     * @brief Constructor (empty; buffers grow on first use)
+     */
+    SearchWorkspace() : epoch_(0), allocations_(0) {}
+
+    /**
+     * @brief Start a new query over a graph with nodeCount nodes
+     *
+     * Only grows buffers when the graph is larger than any seen before;
+     * otherwise this is O(1).
+     */
+    void begin(size_t nodeCount) {
+        stats_ = SearchStats();
+        if (stamp_.size() < nodeCount) {
+            distance_.resize(nodeCount);
+            previous_.resize(nodeCount);
+            stamp_.resize(nodeCount, 0);
+            settled_.resize(nodeCount, 0);
+            ++allocations_;
+            ++stats_.allocations;
+        }
+        heap_.clear();
+        if (++epoch_ == 0) {
+            // Generation counter wrapped: clear stamps once every 2^32 queries
+            std::fill(stamp_.begin(), stamp_.end(), 0u);
+            std::fill(settled_.begin(), settled_.end(), 0u);
+            epoch_ = 1;
+        }
+    }
+
+    /**
+     * @brief Tentative distance of a node in the current query
+     * @return Distance, or infinity if not reached yet
+     */
+    double distance(uint32_t node) const {
+        return stamp_[node] == epoch_ ? distance_[node]
+                                      : std::numeric_limits<double>::infinity();
+    }
+
+    /**
+     * @brief Predecessor of a node in the current query
+     * @return Predecessor index, or NO_NODE
+     */
+    uint32_t previous(uint32_t node) const {
+        return stamp_[node] == epoch_ ? previous_[node] : NO_NODE;
+    }
+
+    /**
+     * @brief Whether the node has been reached in the current query
+     */
+    bool reached(uint32_t node) const {
+        return stamp_[node] == epoch_;
+    }
+
+    /**
+     * @brief Record a (better) tentative distance for a node
+     */
+    void setDistance(uint32_t node, double dist, uint32_t prev) {
+        stamp_[node] = epoch_;
+        distance_[node] = dist;
+        previous_[node] = prev;
+    }
+
+    /**
+     * @brief Relax a node: store dist/prev if it improves the tentative distance
+     * @return True if the distance improved
+     */
+    bool relax(uint32_t node, double dist, uint32_t prev) {
+        ++stats_.edgesRelaxed;
+        if (dist < distance(node)) {
+            setDistance(node, dist, prev);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Whether the node has been settled in the current query
+     */
+    bool isSettled(uint32_t node) const {
+        return settled_[node] == epoch_;
+    }
+
+    /**
+     * @brief Mark a node settled
+     */
+    void settle(uint32_t node) {
+        settled_[node] = epoch_;
+        ++stats_.nodesSettled;
+    }
+
+    /**
+     * @brief Push an entry onto the reusable min-heap
+     */
+    void push(double dist, uint32_t node) {
+        growHeapIfFull();
+        heap_.push_back(QueueEntry(dist, node));
+        std::push_heap(heap_.begin(), heap_.end(), std::greater<QueueEntry>());
+    }
+
+    /**
+     * @brief Peek at the minimum entry of the heap (heap must not be empty)
+     */
+    const QueueEntry& top() const {
+        return heap_.front();
+    }
+
+    /**
+     * @brief Pop the minimum entry from the heap
+     */
+    QueueEntry pop() {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<QueueEntry>());
+        QueueEntry top = heap_.back();
+        heap_.pop_back();
+        return top;
+    }
+
+    /**
+     * @brief Whether the heap is empty
+     */
+    bool empty() const {
+        return heap_.empty();
+    }
+
+    /**
+     * @brief Counters for the current (or last finished) query
+     */
+    const SearchStats& getStats() const {
+        return stats_;
+    }
+
+    /**
+     * @brief Record a growth of a per-thread search buffer kept outside
+     *        the workspace (e.g. a queue policy), counted like its own
+     *
+     * Call between begin() and getStats().
+     */
+    void countAllocation() {
+        ++allocations_;
+        ++stats_.allocations;
+    }
+
+    /**
+     * @brief Total buffer growths since construction
+     *
+     * After warm-up this stays constant: a query that reports
+     * getStats().allocations == 0 did not touch the heap allocator.
+     */
+    size_t getAllocationCount() const {
+        return allocations_;
+    }
+};
+
+#endif // SEARCH_WORKSPACE_H
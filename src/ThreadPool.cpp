@@ -0,0 +1,156 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Implementation of the work-stealing ThreadPool.
+ */
+
+#include "ThreadPool.h"
+#include <algorithm>
+#include <exception>
+
+// Start workers
+ThreadPool::ThreadPool(unsigned threads)
+    : pending_(0), steals_(0), nextQueue_(0), stopping_(false) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        queues_.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        threads_.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+    }
+}
+
+// Stop and join workers
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+// Worker count
+unsigned ThreadPool::size() const {
+    return static_cast<unsigned>(threads_.size());
+}
+
+// Pop own work (FIFO keeps submission order roughly intact)
+bool ThreadPool::popLocal(size_t index, Task& task) {
+    WorkerQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    --pending_;
+    return true;
+}
+
+// Steal from the opposite end of a victim's deque
+bool ThreadPool::steal(size_t index, Task& task) {
+    const size_t count = queues_.size();
+    for (size_t k = 1; k <= count; ++k) {
+        size_t victim = (index + k) % count;
+        if (victim == index) continue;
+        WorkerQueue& queue = *queues_[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            --pending_;
+            ++steals_;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Worker loop: own deque first, then steal, then sleep
+void ThreadPool::workerLoop(size_t index) {
+    while (true) {
+        Task task;
+        if (popLocal(index, task) || steal(index, task)) {
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wake_.wait(lock, [this]() { return stopping_ || pending_.load() > 0; });
+        if (stopping_ && pending_.load() == 0) {
+            return;
+        }
+    }
+}
+
+// Queue a task
+void ThreadPool::submit(Task task) {
+    size_t index = nextQueue_++ % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        ++pending_;
+    }
+    wake_.notify_one();
+}
+
+// Chunked parallel loop
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, size_t)>& body,
+                             size_t grain) {
+    if (count == 0) {
+        return;
+    }
+    if (grain == 0) {
+        // Several chunks per worker so stealing can even out the load
+        grain = std::max<size_t>(1, count / (queues_.size() * 8));
+    }
+
+    struct Batch {
+        std::atomic<size_t> remaining;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+    std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+    batch->remaining = (count + grain - 1) / grain;
+
+    for (size_t begin = 0; begin < count; begin += grain) {
+        size_t end = std::min(count, begin + grain);
+        submit([batch, &body, begin, end]() {
+            try {
+                body(begin, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                if (!batch->error) batch->error = std::current_exception();
+            }
+            if (--batch->remaining == 0) {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                batch->done.notify_all();
+            }
+        });
+    }
+
+    // The caller helps instead of idling
+    Task task;
+    while (batch->remaining.load() > 0 && steal(queues_.size(), task)) {
+        task();
+        task = Task();
+    }
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->done.wait(lock, [&batch]() { return batch->remaining.load() == 0; });
+    if (batch->error) {
+        std::rethrow_exception(batch->error);
+    }
+}
+
+// Steal counter
+size_t ThreadPool::getStealCount() const {
+    return steals_.load();
+}
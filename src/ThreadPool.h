@@ -0,0 +1,116 @@
+/**
+ * @file ThreadPool.h
+ * @brief Small work-stealing thread pool used for batch routing.
+ *
+ * Each worker owns a deque of tasks. A worker pops from the front of its
+ * own deque and, when that runs dry, steals from the back of another
+ * worker's deque, so uneven tasks (long cross-campus routes next to short
+ * hops) still keep every core busy. The thread calling parallelFor() helps
+ * run tasks instead of idling.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <cstddef>
+
+/**
+ * @class ThreadPool
+ * @brief Fixed-size pool of workers with per-worker deques and stealing
+ *
+ * Example usage:
+ * @code
+ * ThreadPool pool(4);
+ * pool.parallelFor(items.size(), [&](size_t begin, size_t end) {
+ *     for (size_t i = begin; i < end; ++i) process(items[i]);
+ * });
+ * @endcode
+ */
+class ThreadPool {
+public:
+    typedef std::function<void()> Task;
+
+private:
+    /**
+     * @struct WorkerQueue
+     * @brief Task deque owned by one worker
+     */
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;  ///< One deque per worker
+    std::vector<std::thread> threads_;                  ///< Worker threads
+    std::mutex wakeMutex_;                              ///< Guards sleeping/waking
+    std::condition_variable wake_;                      ///< Signals new work or shutdown
+    std::atomic<size_t> pending_;                       ///< Tasks queued but not yet taken
+    std::atomic<size_t> steals_;                        ///< Tasks taken from another worker
+    std::atomic<size_t> nextQueue_;                     ///< Round-robin submission cursor
+    bool stopping_;                                     ///< Set by the destructor
+
+    /**
+     * @brief Pop from the front of worker index's own deque
+     */
+    bool popLocal(size_t index, Task& task);
+
+    /**
+     * @brief Steal from the back of any deque other than index
+     */
+    bool steal(size_t index, Task& task);
+
+    /**
+     * @brief Worker main loop
+     */
+    void workerLoop(size_t index);
+
+    /**
+     * @brief Queue a task on the next deque (round-robin)
+     */
+    void submit(Task task);
+
+public:
+    /**
+     * @brief Start the workers
+     * @param threads Number of workers (0 = all hardware threads)
+     */
+    explicit ThreadPool(unsigned threads = 0);
+
+    /**
+     * @brief Finish queued work and join all workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Number of worker threads
+     */
+    unsigned size() const;
+
+    /**
+     * @brief Run body over [0, count) split into chunks; blocks until done
+     * @param count Number of items
+     * @param body Called as body(begin, end) for disjoint chunks
+     * @param grain Items per chunk (0 = choose automatically)
+     * @throws Rethrows the first exception thrown by body
+     */
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)>& body,
+                     size_t grain = 0);
+
+    /**
+     * @brief Total tasks run by a worker other than the one they were queued on
+     */
+    size_t getStealCount() const;
+};
+
+#endif // THREAD_POOL_H
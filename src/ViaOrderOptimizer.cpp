@@ -0,0 +1,200 @@
+/**
+ * @file ViaOrderOptimizer.cpp
+ * @brief Held-Karp and 2-opt/Or-opt via ordering.
+ */
+
+#include "ViaOrderOptimizer.h"
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+namespace {
+
+const double INF = std::numeric_limits<double>::infinity();
+
+// Improvements smaller than this are floating-point noise
+const double MIN_GAIN = 1e-9;
+
+// Largest segment moved by Or-opt
+const size_t OR_OPT_MAX_SEGMENT = 3;
+
+} // namespace
+
+// Choose exact or heuristic solver
+std::vector<size_t> ViaOrderOptimizer::optimize(const std::vector<double>& matrix,
+                                                size_t viaCount) {
+    if (matrix.size() != (viaCount + 2) * (viaCount + 2)) {
+        throw std::invalid_argument("Distance matrix does not match via count");
+    }
+    if (viaCount <= 1) {
+        return std::vector<size_t>(viaCount, 0);
+    }
+    if (viaCount <= HELD_KARP_LIMIT) {
+        return heldKarp(matrix, viaCount);
+    }
+    return localSearch(matrix, viaCount);
+}
+
+// Sum of legs start -> order... -> end
+double ViaOrderOptimizer::tourLength(const std::vector<double>& matrix, size_t viaCount,
+                                     const std::vector<size_t>& order) {
+    const size_t n = viaCount + 2;
+    double total = 0.0;
+    size_t previous = 0;
+    for (size_t via : order) {
+        total += matrix[previous * n + via + 1];
+        previous = via + 1;
+    }
+    return total + matrix[previous * n + viaCount + 1];
+}
+
+/**
+ * @brief Held-Karp dynamic programming
+ *
+ * cost[mask][j] is the shortest walk that leaves start, visits exactly the
+ * vias in mask and stops at via j. Each state extends to every via not yet
+ * in mask; the answer closes the best full-mask state with the leg to end.
+ * Memory is 2^k * k entries, about 4 MB at k = 15.
+ */
+std::vector<size_t> ViaOrderOptimizer::heldKarp(const std::vector<double>& matrix,
+                                                size_t viaCount) {
+    const size_t n = viaCount + 2;
+    const size_t k = viaCount;
+    const size_t full = (static_cast<size_t>(1) << k) - 1;
+    const uint8_t NONE = 0xFF;
+
+    std::vector<double> cost((full + 1) * k, INF);
+    std::vector<uint8_t> parent((full + 1) * k, NONE);
+    for (size_t j = 0; j < k; ++j) {
+        cost[(static_cast<size_t>(1) << j) * k + j] = matrix[0 * n + j + 1];
+    }
+
+    for (size_t mask = 1; mask <= full; ++mask) {
+        for (size_t j = 0; j < k; ++j) {
+            double base = cost[mask * k + j];
+            if (!(mask & (static_cast<size_t>(1) << j)) || base == INF) {
+                continue;
+            }
+            for (size_t next = 0; next < k; ++next) {
+                size_t bit = static_cast<size_t>(1) << next;
+                if (mask & bit) {
+                    continue;
+                }
+                double candidate = base + matrix[(j + 1) * n + next + 1];
+                size_t state = (mask | bit) * k + next;
+                if (candidate < cost[state]) {
+                    cost[state] = candidate;
+                    parent[state] = static_cast<uint8_t>(j);
+                }
+            }
+        }
+    }
+
+    size_t last = k;
+    double best = INF;
+    for (size_t j = 0; j < k; ++j) {
+        double total = cost[full * k + j] + matrix[(j + 1) * n + k + 1];
+        if (total < best) {
+            best = total;
+            last = j;
+        }
+    }
+
+    std::vector<size_t> order;
+    if (last == k) {
+        // No finite tour exists; keep the given order so routing reports it
+        for (size_t j = 0; j < k; ++j) order.push_back(j);
+        return order;
+    }
+
+    // Walk parents back from the best final via
+    size_t mask = full;
+    size_t current = last;
+    while (current != NONE) {
+        order.push_back(current);
+        uint8_t previous = parent[mask * k + current];
+        mask &= ~(static_cast<size_t>(1) << current);
+        current = (previous == NONE) ? NONE : previous;
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+/**
+ * @brief Heuristic for larger via sets
+ *
+ * Builds a nearest-neighbour tour, then alternates two local searches
+ * until neither finds a shorter tour:
+ * - 2-opt reverses a run of vias (removes crossing legs);
+ * - Or-opt moves a run of up to three vias to another position.
+ * Candidate tours are scored with tourLength(), so asymmetric distances
+ * (one-way paths) are handled correctly.
+ */
+std::vector<size_t> ViaOrderOptimizer::localSearch(const std::vector<double>& matrix,
+                                                   size_t viaCount) {
+    const size_t n = viaCount + 2;
+    const size_t k = viaCount;
+
+    // Nearest neighbour construction
+    std::vector<size_t> order;
+    std::vector<bool> used(k, false);
+    size_t current = 0;
+    for (size_t step = 0; step < k; ++step) {
+        size_t pick = k;
+        double nearest = INF;
+        for (size_t v = 0; v < k; ++v) {
+            if (used[v]) continue;
+            if (pick == k || matrix[current * n + v + 1] < nearest) {
+                pick = v;
+                nearest = matrix[current * n + v + 1];
+            }
+        }
+        used[pick] = true;
+        order.push_back(pick);
+        current = pick + 1;
+    }
+
+    double best = tourLength(matrix, k, order);
+    bool improved = true;
+    while (improved) {
+        improved = false;
+
+        // 2-opt: reverse order[i..j]
+        for (size_t i = 0; i + 1 < k; ++i) {
+            for (size_t j = i + 1; j < k; ++j) {
+                std::reverse(order.begin() + i, order.begin() + j + 1);
+                double length = tourLength(matrix, k, order);
+                if (length < best - MIN_GAIN) {
+                    best = length;
+                    improved = true;
+                } else {
+                    std::reverse(order.begin() + i, order.begin() + j + 1);
+                }
+            }
+        }
+
+        // Or-opt: move order[i, i + len) to another position
+        for (size_t len = 1; len <= OR_OPT_MAX_SEGMENT && len < k; ++len) {
+            for (size_t i = 0; i + len <= k; ++i) {
+                std::vector<size_t> segment(order.begin() + i, order.begin() + i + len);
+                std::vector<size_t> rest(order.begin(), order.begin() + i);
+                rest.insert(rest.end(), order.begin() + i + len, order.end());
+                for (size_t position = 0; position <= rest.size(); ++position) {
+                    if (position == i) continue;
+                    std::vector<size_t> candidate(rest.begin(), rest.begin() + position);
+                    candidate.insert(candidate.end(), segment.begin(), segment.end());
+                    candidate.insert(candidate.end(), rest.begin() + position, rest.end());
+                    double length = tourLength(matrix, k, candidate);
+                    if (length < best - MIN_GAIN) {
+                        best = length;
+                        order.swap(candidate);
+                        improved = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return order;
+}
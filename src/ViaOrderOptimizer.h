@@ -0,0 +1,68 @@
+/**
+ * @file ViaOrderOptimizer.h
+ * @brief Shortest visiting order for the vias of a multi-stop route.
+ *
+ * The problem is an open travelling-salesman path with fixed endpoints:
+ * leave start, visit every via once, arrive at end. Input is a dense
+ * distance matrix over the stops. Up to HELD_KARP_LIMIT vias are solved
+ * exactly with Held-Karp dynamic programming (O(2^k * k^2)); larger sets
+ * start from a nearest-neighbour tour and are improved with 2-opt and
+ * Or-opt moves until no move shortens the tour.
+ */
+
+#ifndef VIA_ORDER_OPTIMIZER_H
+#define VIA_ORDER_OPTIMIZER_H
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * @class ViaOrderOptimizer
+ * @brief Orders vias to minimise total route length
+ *
+ * Matrix layout: (k + 2) x (k + 2), row-major, where stop 0 is the start,
+ * stops 1..k are the vias and stop k + 1 is the end. Unreachable pairs
+ * are infinity.
+ *
+ * Example usage:
+ * @code
+ * std::vector<size_t> order = ViaOrderOptimizer::optimize(matrix, vias.size());
+ * // order[i] is the index into vias of the i-th stop to visit
+ * @endcode
+ */
+class ViaOrderOptimizer {
+public:
+    /// Largest via count solved exactly
+    static const size_t HELD_KARP_LIMIT = 15;
+
+    /**
+     * @brief Best visiting order
+     * @param matrix Stop-to-stop distances (see class description)
+     * @param viaCount Number of vias k
+     * @return Permutation of 0..k-1
+     */
+    static std::vector<size_t> optimize(const std::vector<double>& matrix, size_t viaCount);
+
+    /**
+     * @brief Length of start -> vias in order -> end
+     * @param matrix Stop-to-stop distances
+     * @param viaCount Number of vias k
+     * @param order Permutation of 0..k-1
+     * @return Total distance (infinity if a leg is unreachable)
+     */
+    static double tourLength(const std::vector<double>& matrix, size_t viaCount,
+                             const std::vector<size_t>& order);
+
+private:
+    /**
+     * @brief Exact solution by dynamic programming over via subsets
+     */
+    static std::vector<size_t> heldKarp(const std::vector<double>& matrix, size_t viaCount);
+
+    /**
+     * @brief Nearest-neighbour tour improved by 2-opt and Or-opt
+     */
+    static std::vector<size_t> localSearch(const std::vector<double>& matrix, size_t viaCount);
+};
+
+#endif // VIA_ORDER_OPTIMIZER_H
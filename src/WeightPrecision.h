@@ -0,0 +1,161 @@
+/**
+ * @file WeightPrecision.h
+ * @brief Validation of compact edge weight types against double weights.
+ *
+ * Graph<uint32_t, W> with W = float or FixedPointWeight<> halves the edge
+ * record, but every weight is rounded once on insert. Shortest distances
+ * then drift from the double baseline by up to the sum of the rounding
+ * errors along the path, and a route can even change when two paths were
+ * nearly tied. WeightPrecision copies a graph into the compact form,
+ * answers the same queries on both and reports how far the distances
+ * moved, so a weight type can be checked on real data before it is
+ * adopted.
+ */
+
+#ifndef WEIGHT_PRECISION_H
+#define WEIGHT_PRECISION_H
+
+#include "Graph.h"
+#include "CSRGraph.h"
+#include "PriorityQueues.h"
+#include <vector>
+#include <map>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+/**
+ * @struct WeightDriftReport
+ * @brief Distance drift of one weight type over a query set
+ */
+struct WeightDriftReport {
+    size_t bytesPerEdge;            ///< sizeof(Edge<uint32_t, W>)
+    size_t routes;                  ///< Queries reachable in both graphs
+    size_t reachabilityMismatches;  ///< Queries reachable in only one graph
+    double maxAbsoluteDrift;        ///< Largest |compact - baseline| (metres)
+    double meanAbsoluteDrift;       ///< Average |compact - baseline| (metres)
+    double maxRelativeDrift;        ///< Largest drift / baseline distance
+
+    WeightDriftReport()
+        : bytesPerEdge(0), routes(0), reachabilityMismatches(0),
+          maxAbsoluteDrift(0.0), meanAbsoluteDrift(0.0), maxRelativeDrift(0.0) {}
+};
+
+/**
+ * @class WeightPrecision
+ * @brief Measures route-distance drift of a compact weight type
+ *
+ * Example usage:
+ * @code
+ * WeightDriftReport r = WeightPrecision::measureDrift<float>(graph, queries);
+ * WeightDriftReport c = WeightPrecision::measureDrift<FixedPointWeight<100> >(graph, queries);
+ * @endcode
+ */
+class WeightPrecision {
+public:
+    /**
+     * @brief Compare shortest distances on a compact copy with the original
+     * @param baseline Graph with double weights
+     * @param queries (start, end) pairs to compare
+     * @return Drift statistics
+     *
+     * Both graphs are searched with the same Dijkstra and double
+     * accumulation, so the difference comes from weight storage alone.
+     * Queries are grouped by start so each start is searched once.
+     */
+    template<typename W, typename T>
+    static WeightDriftReport measureDrift(const Graph<T>& baseline,
+                                          const std::vector<std::pair<T, T>>& queries) {
+        WeightDriftReport report;
+        report.bytesPerEdge = sizeof(Edge<uint32_t, W>);
+
+        // Same dense numbering for both copies
+        const std::vector<T> nodes = baseline.getAllNodes();
+        const CSRGraph<T> exact(baseline, nodes);
+        Graph<uint32_t, W> compact;
+        std::vector<uint32_t> order(nodes.size());
+        for (uint32_t u = 0; u < nodes.size(); ++u) {
+            order[u] = u;
+            compact.addNode(u);
+        }
+        for (uint32_t u = 0; u < nodes.size(); ++u) {
+            for (const Edge<T>& edge : baseline.neighbors(nodes[u])) {
+                compact.addEdge(u, exact.indexOf(edge.destination), edge.weight);
+            }
+        }
+        const CSRGraph<uint32_t> rounded(compact, order);
+
+        std::map<uint32_t, std::vector<uint32_t>> targetsBySource;
+        for (const std::pair<T, T>& q : queries) {
+            if (exact.hasNode(q.first) && exact.hasNode(q.second)) {
+                targetsBySource[exact.indexOf(q.first)].push_back(exact.indexOf(q.second));
+            }
+        }
+
+        double driftSum = 0.0;
+        std::vector<double> exactDist, roundedDist;
+        for (const auto& entry : targetsBySource) {
+            distancesFrom(exact, entry.first, exactDist);
+            distancesFrom(rounded, entry.first, roundedDist);
+            for (uint32_t target : entry.second) {
+                double a = exactDist[target];
+                double b = roundedDist[target];
+                bool reachableA = a != std::numeric_limits<double>::infinity();
+                bool reachableB = b != std::numeric_limits<double>::infinity();
+                if (reachableA != reachableB) {
+                    ++report.reachabilityMismatches;
+                    continue;
+                }
+                if (!reachableA) {
+                    continue;
+                }
+                double drift = std::fabs(b - a);
+                ++report.routes;
+                driftSum += drift;
+                report.maxAbsoluteDrift = std::max(report.maxAbsoluteDrift, drift);
+                if (a > 0.0) {
+                    report.maxRelativeDrift = std::max(report.maxRelativeDrift, drift / a);
+                }
+            }
+        }
+        if (report.routes > 0) {
+            report.meanAbsoluteDrift = driftSum / report.routes;
+        }
+        return report;
+    }
+
+private:
+    /**
+     * @brief One-to-all Dijkstra on a CSR graph
+     */
+    template<typename T>
+    static void distancesFrom(const CSRGraph<T>& graph, uint32_t source,
+                              std::vector<double>& dist) {
+        const double inf = std::numeric_limits<double>::infinity();
+        dist.assign(graph.getNodeCount(), inf);
+        std::vector<bool> settled(graph.getNodeCount(), false);
+        BinaryHeapQueue queue;
+        queue.clear(graph.getNodeCount());
+        dist[source] = 0.0;
+        queue.push(0.0, source);
+        while (!queue.empty()) {
+            BinaryHeapQueue::Entry top = queue.pop();
+            uint32_t u = top.second;
+            if (settled[u]) {
+                continue;
+            }
+            settled[u] = true;
+            for (const CSREdge& edge : graph.neighbors(u)) {
+                double candidate = dist[u] + edge.weight;
+                if (candidate < dist[edge.target]) {
+                    dist[edge.target] = candidate;
+                    queue.push(candidate, edge.target);
+                }
+            }
+        }
+    }
+};
+
+#endif // WEIGHT_PRECISION_H
@@ -0,0 +1,1522 @@
+/**
+ * @file benchmark.cpp
+ * @brief Console benchmark for the routing engine (no GUI required).
+ *
+ * Builds a synthetic campus-like grid far larger than CampusData so that
+ * the cost of graph layout and search strategy becomes visible, then times
+ * random point-to-point queries.
+ *
+ * Usage: CampusBenchmark [gridSide] [queries]
+ *        CampusBenchmark --osm <extract.osm | extract.osm.pbf> [queries]
+ *
+ * With --osm the graph-independent sections run on the footpath network
+ * of a local OpenStreetMap extract instead of the synthetic grid.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <map>
+#include <queue>
+#include <random>
+#include <chrono>
+#include <limits>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <functional>
+#include <thread>
+#include <algorithm>
+#include <string>
+#include <atomic>
+#include <new>
+#include <fstream>
+
+#include "Location.h"
+#include "Graph.h"
+#include "CSRGraph.h"
+#include "Navigator.h"
+#include "WalkingMode.h"
+#include "CyclingMode.h"
+#include "DeltaStepping.h"
+#include "WeightPrecision.h"
+#include "CampusDataLoader.h"
+#include "OsmImporter.h"
+
+// Heap allocations made by this process, counted by the global
+// operator new below so benchmarks can report allocations per query
+static std::atomic<size_t> heapAllocations(0);
+
+void* operator new(size_t size) {
+    ++heapAllocations;
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief Milliseconds elapsed since a start time point
+ */
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * @struct SyntheticCampus
+ * @brief Grid of locations with jittered coordinates and street-like edges
+ */
+struct SyntheticCampus {
+    std::vector<Location*> locations;
+    std::vector<std::pair<int, int>> connections;
+    std::vector<double> distances;
+
+    ~SyntheticCampus() {
+        for (Location* loc : locations) {
+            delete loc;
+        }
+    }
+};
+
+/**
+ * @brief Build a side x side grid around the real campus centre
+ *
+ * Neighbouring grid cells are connected; about 10% of the edges are
+ * dropped so that routes are not trivially straight lines.
+ */
+void buildSyntheticCampus(int side, SyntheticCampus& campus) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> jitter(-0.00002, 0.00002);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+    const double baseLat = 12.8300;
+    const double baseLon = 80.1300;
+    const double step = 0.0001;     // roughly 11 m
+
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            int id = r * side + c;
+            campus.locations.push_back(new Location(
+                "node_" + std::to_string(id),
+                baseLat + r * step + jitter(rng),
+                baseLon + c * step + jitter(rng),
+                "[hidden]", id));
+        }
+    }
+
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            int id = r * side + c;
+            int right = id + 1;
+            int down = id + side;
+            if (c + 1 < side && coin(rng) > 0.1) {
+                campus.connections.push_back({id, right});
+                campus.distances.push_back(campus.locations[id]->distanceTo(*campus.locations[right]));
+            }
+            if (r + 1 < side && coin(rng) > 0.1) {
+                campus.connections.push_back({id, down});
+                campus.distances.push_back(campus.locations[id]->distanceTo(*campus.locations[down]));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Random (start, end) query pairs
+ */
+std::vector<std::pair<Location*, Location*>> makeQueries(const std::vector<Location*>& locations,
+                                                         int count) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<size_t> pick(0, locations.size() - 1);
+    std::vector<std::pair<Location*, Location*>> queries;
+    for (int i = 0; i < count; ++i) {
+        queries.push_back({locations[pick(rng)], locations[pick(rng)]});
+    }
+    return queries;
+}
+
+/**
+ * @brief Reference Dijkstra over the map-based Graph<T> adjacency
+ *
+ * CopyNeighbors = true scans getNeighbors() copies, as the search loops
+ * did before Graph::neighbors() borrowed the stored edges.
+ */
+template<bool CopyNeighbors = false>
+double mapDijkstra(const Graph<Location*>& graph, Location* start, Location* end) {
+    std::map<Location*, double> dist;
+    std::priority_queue<std::pair<double, Location*>,
+                        std::vector<std::pair<double, Location*>>,
+                        std::greater<std::pair<double, Location*>>> pq;
+    dist[start] = 0.0;
+    pq.push({0.0, start});
+    while (!pq.empty()) {
+        double d = pq.top().first;
+        Location* u = pq.top().second;
+        pq.pop();
+        if (d > dist[u]) continue;
+        if (u == end) return d;
+        auto relax = [&](const Edge<Location*>& e) {
+            auto it = dist.find(e.destination);
+            double nd = d + e.weight;
+            if (it == dist.end() || nd < it->second) {
+                dist[e.destination] = nd;
+                pq.push({nd, e.destination});
+            }
+        };
+        if (CopyNeighbors) {
+            for (const Edge<Location*>& e : graph.getNeighbors(u)) relax(e);
+        } else {
+            for (const Edge<Location*>& e : graph.neighbors(u)) relax(e);
+        }
+    }
+    return std::numeric_limits<double>::infinity();
+}
+
+/**
+ * @brief Same Dijkstra, but scanning the frozen CSR arrays
+ */
+double csrDijkstra(const CSRGraph<Location*>& csr, uint32_t start, uint32_t end) {
+    std::vector<double> dist(csr.getNodeCount(), std::numeric_limits<double>::infinity());
+    std::priority_queue<std::pair<double, uint32_t>,
+                        std::vector<std::pair<double, uint32_t>>,
+                        std::greater<std::pair<double, uint32_t>>> pq;
+    dist[start] = 0.0;
+    pq.push({0.0, start});
+    while (!pq.empty()) {
+        double d = pq.top().first;
+        uint32_t u = pq.top().second;
+        pq.pop();
+        if (d > dist[u]) continue;
+        if (u == end) return d;
+        for (const CSREdge& e : csr.neighbors(u)) {
+            double nd = d + e.weight;
+            if (nd < dist[e.target]) {
+                dist[e.target] = nd;
+                pq.push({nd, e.target});
+            }
+        }
+    }
+    return std::numeric_limits<double>::infinity();
+}
+
+/**
+ * @brief Compare map-based adjacency with the CSR layout
+ */
+void benchGraphLayout(const SyntheticCampus& campus, Navigator& navigator,
+                      const std::vector<std::pair<Location*, Location*>>& queries) {
+    std::cout << "\n[Graph layout: std::map adjacency vs CSR]\n";
+    const Graph<Location*>& graph = navigator.getGraph();
+    const CSRGraph<Location*>& csr = navigator.getRoutingGraph();
+
+    Clock::time_point t0 = Clock::now();
+    CSRGraph<Location*> rebuilt(graph, campus.locations);
+    std::cout << "  CSR build:        " << elapsedMs(t0) << " ms ("
+              << rebuilt.memoryBytes() / 1024 << " KiB)\n";
+
+    double checksumMap = 0.0;
+    t0 = Clock::now();
+    for (const auto& q : queries) {
+        checksumMap += mapDijkstra(graph, q.first, q.second);
+    }
+    double mapMs = elapsedMs(t0);
+
+    double checksumCsr = 0.0;
+    t0 = Clock::now();
+    for (const auto& q : queries) {
+        checksumCsr += csrDijkstra(csr, csr.indexOf(q.first), csr.indexOf(q.second));
+    }
+    double csrMs = elapsedMs(t0);
+
+    std::cout << "  map Dijkstra:     " << mapMs << " ms\n";
+    std::cout << "  CSR Dijkstra:     " << csrMs << " ms  (x" << mapMs / csrMs << ")\n";
+    std::cout << "  checksum match:   " << (std::abs(checksumMap - checksumCsr) < 1e-6 ? "yes" : "NO") << "\n";
+
+    t0 = Clock::now();
+    size_t found = 0;
+    for (const auto& q : queries) {
+        try {
+            navigator.findPath(q.first, q.second);
+            ++found;
+        } catch (const PathNotFoundException&) {
+        }
+    }
+    std::cout << "  Navigator::findPath: " << elapsedMs(t0) << " ms (" << found << " routes)\n";
+}
+
+/**
+ * @brief Neighbor iteration on Graph: getNeighbors() copies vs borrowed ranges
+ *
+ * Counts heap allocations per map-based Dijkstra query and per sweep over
+ * every node's edges, the access pattern of GUIHandler::drawPaths().
+ */
+void benchNeighborIteration(const Navigator& navigator,
+                            const std::vector<std::pair<Location*, Location*>>& queries) {
+    std::cout << "\n[Graph neighbor iteration: copied vs borrowed]\n";
+    const Graph<Location*>& graph = navigator.getGraph();
+
+    double checksumCopy = 0.0, checksumBorrow = 0.0;
+    size_t before = heapAllocations.load();
+    Clock::time_point t0 = Clock::now();
+    for (const auto& q : queries) {
+        checksumCopy += mapDijkstra<true>(graph, q.first, q.second);
+    }
+    double copyMs = elapsedMs(t0);
+    size_t copyAllocations = heapAllocations.load() - before;
+
+    before = heapAllocations.load();
+    t0 = Clock::now();
+    for (const auto& q : queries) {
+        checksumBorrow += mapDijkstra<false>(graph, q.first, q.second);
+    }
+    double borrowMs = elapsedMs(t0);
+    size_t borrowAllocations = heapAllocations.load() - before;
+
+    const double n = static_cast<double>(queries.size());
+    std::cout << "  map Dijkstra, getNeighbors(): " << copyMs << " ms, "
+              << copyAllocations / n << " allocations/query\n";
+    std::cout << "  map Dijkstra, neighbors():    " << borrowMs << " ms, "
+              << borrowAllocations / n << " allocations/query"
+              << (std::abs(checksumCopy - checksumBorrow) < 1e-6 ? "" : " (CHECKSUM MISMATCH)") << "\n";
+
+    // One drawPaths-style pass over all edges
+    const std::vector<Location*> nodes = graph.getAllNodes();
+    const int sweeps = 20;
+    double lengthCopy = 0.0, lengthBorrow = 0.0;
+    before = heapAllocations.load();
+    t0 = Clock::now();
+    for (int s = 0; s < sweeps; ++s) {
+        for (Location* loc : nodes) {
+            for (const Edge<Location*>& e : graph.getNeighbors(loc)) lengthCopy += e.weight;
+        }
+    }
+    copyMs = elapsedMs(t0);
+    copyAllocations = heapAllocations.load() - before;
+
+    before = heapAllocations.load();
+    t0 = Clock::now();
+    for (int s = 0; s < sweeps; ++s) {
+        for (Location* loc : nodes) {
+            for (const Edge<Location*>& e : graph.neighbors(loc)) lengthBorrow += e.weight;
+        }
+    }
+    borrowMs = elapsedMs(t0);
+    borrowAllocations = heapAllocations.load() - before;
+
+    std::cout << "  full edge sweep, getNeighbors(): " << copyMs / sweeps << " ms, "
+              << copyAllocations / sweeps << " allocations/sweep\n";
+    std::cout << "  full edge sweep, neighbors():    " << borrowMs / sweeps << " ms, "
+              << borrowAllocations / sweeps << " allocations/sweep"
+              << (lengthCopy == lengthBorrow ? "" : " (CHECKSUM MISMATCH)") << "\n";
+}
+
+/**
+ * @brief Short queries on the reusable workspace: time and allocations
+ *
+ * Each query goes from a random node to one a few grid steps away, so it
+ * settles only a handful of nodes; an O(V) reset per query would dominate.
+ */
+void benchWorkspace(const SyntheticCampus& campus, Navigator& navigator, int side, int count) {
+    std::cout << "\n[Reusable search workspace: short queries]\n";
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> pick(0, side - 4);
+    std::vector<std::pair<Location*, Location*>> queries;
+    for (int i = 0; i < count; ++i) {
+        int r = pick(rng);
+        int c = pick(rng);
+        queries.push_back({campus.locations[r * side + c], campus.locations[(r + 3) * side + c + 3]});
+    }
+
+    // Warm-up grows the thread's workspace to the graph size
+    try { navigator.findPath(queries[0].first, queries[0].second); } catch (const std::exception&) {}
+    size_t before = Navigator::threadWorkspace().getAllocationCount();
+
+    size_t settled = 0;
+    Clock::time_point t0 = Clock::now();
+    for (const auto& q : queries) {
+        try {
+            navigator.findPath(q.first, q.second);
+        } catch (const PathNotFoundException&) {
+        }
+        settled += navigator.getLastSearchStats().nodesSettled;
+    }
+    double ms = elapsedMs(t0);
+    size_t allocations = Navigator::threadWorkspace().getAllocationCount() - before;
+
+    std::cout << "  " << count << " queries:    " << ms << " ms (" << 1000.0 * ms / count << " us/query)\n";
+    std::cout << "  avg nodes settled: " << static_cast<double>(settled) / count << "\n";
+    std::cout << "  search buffer allocations after warm-up: " << allocations
+              << (allocations == 0 ? " (allocation-free)" : "") << "\n";
+}
+
+/**
+ * @brief Compare the nodes settled by each engine on the same queries
+ */
+void benchEngines(Navigator& navigator,
+                  const std::vector<std::pair<Location*, Location*>>& queries) {
+    std::cout << "\n[Search engines: settled nodes and time]\n";
+    const ContractionHierarchy& ch = navigator.buildContractionHierarchy();
+    std::cout << "  CH preprocessing: " << ch.getBuildMillis() << " ms, "
+              << ch.getShortcutCount() << " shortcuts\n";
+
+    const SearchEngine engines[] = { SearchEngine::Dijkstra, SearchEngine::AStar,
+                                     SearchEngine::Bidirectional,
+                                     SearchEngine::ContractionHierarchies };
+    const char* names[] = { "Dijkstra", "A*", "Bidirectional", "CH" };
+    std::vector<double> reference;
+
+    for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); ++e) {
+        size_t settled = 0;
+        size_t mismatches = 0;
+        Clock::time_point t0 = Clock::now();
+        for (size_t i = 0; i < queries.size(); ++i) {
+            double dist = std::numeric_limits<double>::infinity();
+            try {
+                dist = navigator.findPath(queries[i].first, queries[i].second, engines[e]).getTotalDistance();
+            } catch (const PathNotFoundException&) {
+            }
+            settled += navigator.getLastSearchStats().nodesSettled;
+            if (e == 0) {
+                reference.push_back(dist);
+            } else if (std::abs(reference[i] - dist) > 1e-6 && !(std::isinf(reference[i]) && std::isinf(dist))) {
+                ++mismatches;
+            }
+        }
+        double ms = elapsedMs(t0);
+        std::cout << "  " << std::left << std::setw(14) << names[e] << std::right
+                  << ms << " ms, avg settled " << static_cast<double>(settled) / queries.size()
+                  << (e == 0 ? "" : (mismatches == 0 ? ", distances match" : ", DISTANCE MISMATCH"))
+                  << "\n";
+    }
+}
+
+/**
+ * @brief All-pairs table cost for growing graph sizes
+ *
+ * Reports build time and memory so it is clear where the O(V^2) table
+ * stops being worthwhile, then compares table walks with Dijkstra.
+ */
+void benchAllPairs() {
+    std::cout << "\n[All-pairs table: build cost by size]\n";
+    const int sides[] = { 10, 20, 40, 60 };
+    for (int side : sides) {
+        SyntheticCampus campus;
+        buildSyntheticCampus(side, campus);
+        Navigator navigator;
+        navigator.initializeGraph(campus.locations, campus.connections, campus.distances);
+        const AllPairsTable& table = navigator.buildAllPairsTable();
+
+        std::vector<std::pair<Location*, Location*>> queries = makeQueries(campus.locations, 2000);
+        double ms[2];
+        const SearchEngine engines[] = { SearchEngine::Dijkstra, SearchEngine::AllPairsTable };
+        for (int e = 0; e < 2; ++e) {
+            Clock::time_point t0 = Clock::now();
+            for (const auto& q : queries) {
+                try {
+                    navigator.findPath(q.first, q.second, engines[e]);
+                } catch (const PathNotFoundException&) {
+                }
+            }
+            ms[e] = elapsedMs(t0);
+        }
+        std::cout << "  " << std::setw(5) << campus.locations.size() << " nodes: build "
+                  << table.getBuildMillis() << " ms on " << table.getThreadsUsed() << " threads, "
+                  << table.getMemoryBytes() / 1024 << " KiB; 2000 queries Dijkstra "
+                  << ms[0] << " ms vs table " << ms[1] << " ms\n";
+    }
+}
+
+/**
+ * @brief Dijkstra under every queue policy on differently shaped graphs
+ *
+ * "grid" is the synthetic campus; "hubs" adds a few high-degree gate
+ * nodes linked to hundreds of buildings, which stresses decrease-key.
+ * Distances must agree across policies; the fastest is reported.
+ */
+void benchQueuePolicies(int side) {
+    std::cout << "\n[Dijkstra queue policy by graph shape]\n";
+    const char* names[] = { "binary", "4-ary", "pairing", "radix" };
+    const QueuePolicy policies[] = { QueuePolicy::BinaryHeap, QueuePolicy::QuaternaryHeap,
+                                     QueuePolicy::PairingHeap, QueuePolicy::RadixHeap };
+    for (int shape = 0; shape < 2; ++shape) {
+        SyntheticCampus campus;
+        buildSyntheticCampus(side, campus);
+        if (shape == 1) {
+            std::mt19937 rng(31);
+            std::uniform_int_distribution<size_t> pick(0, campus.locations.size() - 1);
+            for (int hub = 0; hub < 20; ++hub) {
+                size_t from = pick(rng);
+                for (int k = 0; k < 300; ++k) {
+                    size_t to = pick(rng);
+                    campus.connections.push_back({static_cast<int>(from), static_cast<int>(to)});
+                    campus.distances.push_back(
+                        1.2 * campus.locations[from]->distanceTo(*campus.locations[to]));
+                }
+            }
+        }
+        Navigator navigator;
+        navigator.initializeGraph(campus.locations, campus.connections, campus.distances);
+        std::vector<std::pair<Location*, Location*>> queries = makeQueries(campus.locations, 300);
+
+        std::vector<double> reference;
+        size_t best = 0;
+        double bestMs = 0.0;
+        std::cout << "  " << (shape == 0 ? "grid" : "hubs") << " ("
+                  << navigator.getRoutingGraph().getEdgeCount() << " edges):";
+        for (size_t p = 0; p < 4; ++p) {
+            navigator.setQueuePolicy(policies[p]);
+            std::vector<double> lengths;
+            Clock::time_point t0 = Clock::now();
+            for (const auto& q : queries) {
+                try {
+                    lengths.push_back(navigator.findPath(q.first, q.second,
+                                                         SearchEngine::Dijkstra).getTotalDistance());
+                } catch (const PathNotFoundException&) {
+                    lengths.push_back(-1.0);
+                }
+            }
+            double ms = elapsedMs(t0);
+            if (p == 0) {
+                reference = lengths;
+            }
+            bool same = true;
+            for (size_t i = 0; i < lengths.size(); ++i) {
+                if (std::fabs(lengths[i] - reference[i]) > 1e-6) same = false;
+            }
+            std::cout << " " << names[p] << " " << ms << " ms" << (same ? "" : " (MISMATCH)");
+            if (p == 0 || ms < bestMs) {
+                best = p;
+                bestMs = ms;
+            }
+        }
+        std::cout << " -> best: " << names[best] << "\n";
+    }
+}
+
+/**
+ * @brief Dial's bucket queue at several quantization steps vs exact Dijkstra
+ *
+ * The observed error of each route is checked against the bound
+ * (edges on Dial's path + edges on the exact path) * step / 2.
+ */
+void benchDial(Navigator& navigator, const std::vector<std::pair<Location*, Location*>>& queries) {
+    std::cout << "\n[Dial's bucket queue: quantization step vs error]\n";
+    std::vector<Path> exact;
+    Clock::time_point t0 = Clock::now();
+    for (const auto& q : queries) {
+        try {
+            exact.push_back(navigator.findPath(q.first, q.second, SearchEngine::Dijkstra));
+        } catch (const PathNotFoundException&) {
+            exact.push_back(Path());
+        }
+    }
+    double dijkstraMs = elapsedMs(t0);
+    std::cout << "  Dijkstra (binary heap): " << dijkstraMs << " ms\n";
+
+    const double previousStep = navigator.getQuantizationStep();
+    const double steps[] = { 10.0, 1.0, 0.1 };
+    for (double step : steps) {
+        navigator.setQuantizationStep(step);
+        double maxError = 0.0, maxRelative = 0.0, maxBound = 0.0;
+        int violations = 0;
+        t0 = Clock::now();
+        for (size_t i = 0; i < queries.size(); ++i) {
+            if (exact[i].empty()) continue;
+            Path dial = navigator.findPath(queries[i].first, queries[i].second, SearchEngine::Dial);
+            double error = dial.getTotalDistance() - exact[i].getTotalDistance();
+            double edges = static_cast<double>(dial.getLocations().size() + exact[i].getLocations().size() - 2);
+            double bound = edges * step / 2.0;
+            if (error > bound + 1e-9 || error < -1e-9) ++violations;
+            maxError = std::max(maxError, error);
+            maxBound = std::max(maxBound, bound);
+            if (exact[i].getTotalDistance() > 0.0) {
+                maxRelative = std::max(maxRelative, error / exact[i].getTotalDistance());
+            }
+        }
+        double ms = elapsedMs(t0);
+        std::cout << "  step " << std::setw(5) << step << " m: " << ms << " ms, max error "
+                  << maxError << " m (" << 100.0 * maxRelative << "%), bound up to "
+                  << maxBound << " m, " << violations << " bound violations\n";
+    }
+    navigator.setQuantizationStep(previousStep);
+}
+
+/**
+ * @brief Startup from a mapped snapshot vs building the graph
+ *
+ * Writes the campus to a snapshot, loads it into a fresh Navigator with
+ * and without checksum verification, and checks that the loaded
+ * Navigator answers every query with the same distance.
+ */
+void benchSnapshot(const SyntheticCampus& campus, const Navigator& navigator,
+                   const std::vector<std::pair<Location*, Location*>>& queries) {
+    std::cout << "\n[Graph snapshot: mmap startup vs rebuild]\n";
+    const std::string path = "campus_benchmark.snap";
+
+    Clock::time_point t0 = Clock::now();
+    {
+        Navigator rebuilt;
+        rebuilt.initializeGraph(campus.locations, campus.connections, campus.distances);
+    }
+    std::cout << "  initializeGraph:        " << elapsedMs(t0) << " ms\n";
+
+    t0 = Clock::now();
+    navigator.saveSnapshot(path);
+    std::cout << "  saveSnapshot:           " << elapsedMs(t0) << " ms\n";
+
+    Navigator loaded;
+    t0 = Clock::now();
+    loaded.loadSnapshot(path, false);
+    std::cout << "  loadSnapshot:           " << elapsedMs(t0) << " ms (no checksum)\n";
+    t0 = Clock::now();
+    loaded.loadSnapshot(path, true);
+    std::cout << "  loadSnapshot:           " << elapsedMs(t0) << " ms (checksum verified)\n";
+
+    std::map<int, Location*> byId;
+    for (Location* loc : loaded.getAllLocations()) {
+        byId[loc->getId()] = loc;
+    }
+    int mismatches = 0;
+    t0 = Clock::now();
+    for (const auto& q : queries) {
+        double expected = -1.0, actual = -1.0;
+        try {
+            expected = navigator.route(q.first, q.second).distanceMeters;
+        } catch (const PathNotFoundException&) {
+        }
+        try {
+            actual = loaded.route(byId.at(q.first->getId()), byId.at(q.second->getId())).distanceMeters;
+        } catch (const PathNotFoundException&) {
+        }
+        if (expected != actual) ++mismatches;
+    }
+    std::cout << "  " << queries.size() << " queries on mapped graph: " << elapsedMs(t0)
+              << " ms, " << mismatches << " distance mismatches, external arrays: "
+              << (loaded.getRoutingGraph().isExternal() ? "yes" : "NO") << "\n";
+    std::remove(path.c_str());
+}
+
+/**
+ * @brief Streaming CSV / GeoJSON import of the synthetic campus
+ *
+ * Writes every node as a building and every connection as a path in both
+ * formats, then streams the files back through counting callbacks.
+ * Heap allocations per record show that memory stays bounded: records are
+ * not retained and the parser reuses its buffers.
+ */
+void benchCampusLoader(const SyntheticCampus& campus) {
+    std::cout << "\n[Campus data loader: streaming CSV / GeoJSON]\n";
+    const std::string csvPath = "campus_benchmark.csv";
+    const std::string jsonPath = "campus_benchmark.geojson";
+    {
+        std::ofstream csv(csvPath.c_str(), std::ios::binary);
+        std::ofstream json(jsonPath.c_str(), std::ios::binary);
+        csv << std::setprecision(7) << std::fixed;
+        json << std::setprecision(7) << std::fixed;
+        csv << "kind,name,latitude,longitude,description,type,from,to,distance\n";
+        json << "{\"type\":\"FeatureCollection\",\"features\":[\n";
+        bool first = true;
+        for (const Location* loc : campus.locations) {
+            csv << "building," << loc->getName() << ',' << loc->getLatitude() << ','
+                << loc->getLongitude() << ",\"Grid node, synthetic\",Landmark,,,\n";
+            json << (first ? "" : ",\n")
+                 << "{\"type\":\"Feature\",\"geometry\":{\"type\":\"Point\",\"coordinates\":["
+                 << loc->getLongitude() << ',' << loc->getLatitude()
+                 << "]},\"properties\":{\"name\":\"" << loc->getName()
+                 << "\",\"type\":\"Landmark\"}}";
+            first = false;
+        }
+        for (size_t i = 0; i < campus.connections.size(); ++i) {
+            const Location* a = campus.locations[campus.connections[i].first];
+            const Location* b = campus.locations[campus.connections[i].second];
+            csv << "path,,,,,," << a->getName() << ',' << b->getName() << ','
+                << campus.distances[i] << '\n';
+            // Length left to the loader: measured along the line
+            json << ",\n{\"type\":\"Feature\",\"geometry\":{\"type\":\"LineString\",\"coordinates\":[["
+                 << a->getLongitude() << ',' << a->getLatitude() << "],["
+                 << b->getLongitude() << ',' << b->getLatitude()
+                 << "]]},\"properties\":{\"from\":\"" << a->getName() << "\",\"to\":\""
+                 << b->getName() << "\"}}";
+        }
+        json << "\n]}\n";
+    }
+
+    const std::string paths[] = { csvPath, jsonPath };
+    for (const std::string& path : paths) {
+        std::ifstream probe(path.c_str(), std::ios::binary | std::ios::ate);
+        double megabytes = static_cast<double>(probe.tellg()) / (1024.0 * 1024.0);
+        size_t buildings = 0, pathCount = 0;
+        double totalLength = 0.0;
+        size_t allocationsBefore = heapAllocations.load();
+        Clock::time_point t0 = Clock::now();
+        LoadReport report = CampusDataLoader::loadFile(path,
+            [&buildings](const CampusData::BuildingInfo&) { ++buildings; },
+            [&pathCount, &totalLength](const CampusData::PathConnection& p) {
+                ++pathCount;
+                totalLength += p.distanceMeters;
+            });
+        double ms = elapsedMs(t0);
+        size_t allocations = heapAllocations.load() - allocationsBefore;
+        double expectedLength = 0.0;
+        for (double d : campus.distances) expectedLength += d;
+        bool countsMatch = buildings == campus.locations.size() &&
+                           pathCount == campus.connections.size() && report.errorCount == 0;
+        std::cout << "  " << std::setw(26) << std::left << path << std::right
+                  << megabytes << " MB in " << ms << " ms (" << megabytes / (ms / 1000.0)
+                  << " MB/s), " << report.buildings + report.paths << " records, "
+                  << static_cast<double>(allocations) / (report.buildings + report.paths)
+                  << " allocations/record, counts " << (countsMatch ? "OK" : "MISMATCH")
+                  << ", length drift " << std::fabs(totalLength - expectedLength) << " m\n";
+        std::remove(path.c_str());
+    }
+}
+
+/**
+ * @brief Append a protobuf varint
+ */
+void appendVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+/**
+ * @brief Append a length-delimited protobuf field
+ */
+void appendBytesField(std::string& out, uint32_t field, const std::string& bytes) {
+    appendVarint(out, (field << 3) | 2);
+    appendVarint(out, bytes.size());
+    out += bytes;
+}
+
+/**
+ * @brief Append a packed sint64 field, delta coded
+ */
+void appendDeltaField(std::string& out, uint32_t field, const std::vector<int64_t>& values) {
+    std::string packed;
+    int64_t previous = 0;
+    for (int64_t value : values) {
+        int64_t delta = value - previous;
+        previous = value;
+        appendVarint(packed, (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+    }
+    appendBytesField(out, field, packed);
+}
+
+/**
+ * @brief Write one uncompressed PBF blob
+ */
+void writePbfBlob(std::ofstream& out, const std::string& type, const std::string& block) {
+    std::string blob, header;
+    appendBytesField(blob, 1, block);
+    appendBytesField(header, 1, type);
+    appendVarint(header, (3 << 3) | 0);
+    appendVarint(header, blob.size());
+    unsigned char size[4] = {
+        static_cast<unsigned char>(header.size() >> 24), static_cast<unsigned char>(header.size() >> 16),
+        static_cast<unsigned char>(header.size() >> 8), static_cast<unsigned char>(header.size()) };
+    out.write(reinterpret_cast<const char*>(size), 4);
+    out << header << blob;
+}
+
+/**
+ * @brief Write the campus as OSM XML and as (uncompressed) OSM PBF
+ *
+ * Node i becomes OSM node i + 1 and every connection a two-node footway,
+ * so an import must give back the same locations and connections.
+ */
+void writeCampusOsm(const SyntheticCampus& campus, const std::string& xmlPath,
+                    const std::string& pbfPath) {
+    std::ofstream xml(xmlPath.c_str(), std::ios::binary);
+    xml << std::fixed << std::setprecision(7)
+        << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<osm version=\"0.6\">\n";
+    for (size_t i = 0; i < campus.locations.size(); ++i) {
+        xml << " <node id=\"" << i + 1 << "\" lat=\"" << campus.locations[i]->getLatitude()
+            << "\" lon=\"" << campus.locations[i]->getLongitude() << "\"/>\n";
+    }
+    for (size_t w = 0; w < campus.connections.size(); ++w) {
+        xml << " <way id=\"" << w + 1 << "\">\n  <nd ref=\"" << campus.connections[w].first + 1
+            << "\"/>\n  <nd ref=\"" << campus.connections[w].second + 1
+            << "\"/>\n  <tag k=\"highway\" v=\"footway\"/>\n </way>\n";
+    }
+    xml << "</osm>\n";
+
+    std::ofstream pbf(pbfPath.c_str(), std::ios::binary);
+    std::string header;
+    appendBytesField(header, 4, "OsmSchema-V0.6");
+    appendBytesField(header, 4, "DenseNodes");
+    writePbfBlob(pbf, "OSMHeader", header);
+
+    // Strings: 0 = "", 1 = highway, 2 = footway
+    std::string strings;
+    appendBytesField(strings, 1, "");
+    appendBytesField(strings, 1, "highway");
+    appendBytesField(strings, 1, "footway");
+    const size_t perBlock = 8000;
+    for (size_t first = 0; first < campus.locations.size(); first += perBlock) {
+        std::vector<int64_t> ids, lats, lons;
+        for (size_t i = first; i < std::min(first + perBlock, campus.locations.size()); ++i) {
+            ids.push_back(static_cast<int64_t>(i + 1));
+            lats.push_back(std::llround(campus.locations[i]->getLatitude() * 1e7));
+            lons.push_back(std::llround(campus.locations[i]->getLongitude() * 1e7));
+        }
+        std::string dense, group, block;
+        appendDeltaField(dense, 1, ids);
+        appendDeltaField(dense, 8, lats);
+        appendDeltaField(dense, 9, lons);
+        appendBytesField(group, 2, dense);
+        appendBytesField(block, 1, strings);
+        appendBytesField(block, 2, group);
+        writePbfBlob(pbf, "OSMData", block);
+    }
+    for (size_t first = 0; first < campus.connections.size(); first += perBlock) {
+        std::string group, block;
+        for (size_t w = first; w < std::min(first + perBlock, campus.connections.size()); ++w) {
+            std::string way;
+            appendVarint(way, (1 << 3) | 0);
+            appendVarint(way, w + 1);
+            appendBytesField(way, 2, std::string(1, '\x01'));
+            appendBytesField(way, 3, std::string(1, '\x02'));
+            std::vector<int64_t> refs;
+            refs.push_back(campus.connections[w].first + 1);
+            refs.push_back(campus.connections[w].second + 1);
+            appendDeltaField(way, 8, refs);
+            appendBytesField(group, 3, way);
+        }
+        appendBytesField(block, 1, strings);
+        appendBytesField(block, 2, group);
+        writePbfBlob(pbf, "OSMData", block);
+    }
+}
+
+/**
+ * @brief OSM import of the campus: XML vs PBF by decoding thread count
+ *
+ * The imported network must reproduce the campus edges; the total
+ * length differs only by the 1e-7 degree rounding of the coordinates.
+ */
+void benchOsmImport(const SyntheticCampus& campus) {
+    std::cout << "\n[OSM import: XML vs PBF block decoding by thread count]\n";
+    const std::string xmlPath = "campus_benchmark.osm";
+    const std::string pbfPath = "campus_benchmark.osm.pbf";
+    writeCampusOsm(campus, xmlPath, pbfPath);
+
+    double expectedLength = 0.0;
+    for (double d : campus.distances) expectedLength += d;
+
+    std::vector<std::pair<std::string, unsigned>> runs;
+    runs.push_back(std::make_pair(xmlPath, 1u));
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= hardware; threads *= 2) {
+        runs.push_back(std::make_pair(pbfPath, threads));
+    }
+    if ((hardware & (hardware - 1)) != 0) {
+        runs.push_back(std::make_pair(pbfPath, hardware));
+    }
+    for (const auto& run : runs) {
+        OsmImportOptions options;
+        options.threads = run.second;
+        options.largestComponentOnly = false;
+        OsmNetwork network;
+        Clock::time_point t0 = Clock::now();
+        OsmImportReport report = OsmImporter::importFile(run.first, network, options);
+        double ms = elapsedMs(t0);
+        double length = 0.0;
+        for (double d : network.distances) length += d;
+        std::cout << "  " << std::setw(26) << std::left << run.first << std::right
+                  << (run.first == xmlPath ? "" : std::to_string(run.second) + " threads: ")
+                  << ms << " ms (ways " << report.wayPassMillis << ", nodes "
+                  << report.nodePassMillis << ", build " << report.buildMillis << "), "
+                  << network.locations.size() << " locations, " << network.connections.size()
+                  << " connections, length drift " << std::fabs(length - expectedLength) << " m\n";
+    }
+    std::remove(xmlPath.c_str());
+    std::remove(pbfPath.c_str());
+}
+
+/**
+ * @brief Compact edge weight types: storage size vs route-distance drift
+ *
+ * Each weight type is checked on a copy of the campus graph with 32-bit
+ * node indices, against the double-weight Location* graph as baseline.
+ */
+void benchWeightPrecision(const Navigator& navigator,
+                          const std::vector<std::pair<Location*, Location*>>& queries) {
+    std::cout << "\n[Edge weight types: drift vs double baseline]\n";
+    const Graph<Location*>& graph = navigator.getGraph();
+    std::cout << "  double, Location* nodes: " << sizeof(Edge<Location*>) << " bytes/edge\n";
+
+    std::vector<std::pair<std::string, WeightDriftReport>> reports;
+    reports.push_back(std::make_pair("double",
+        WeightPrecision::measureDrift<double>(graph, queries)));
+    reports.push_back(std::make_pair("float",
+        WeightPrecision::measureDrift<float>(graph, queries)));
+    reports.push_back(std::make_pair("fixed 1 cm",
+        WeightPrecision::measureDrift<FixedPointWeight<100> >(graph, queries)));
+    reports.push_back(std::make_pair("fixed 1 mm",
+        WeightPrecision::measureDrift<FixedPointWeight<1000> >(graph, queries)));
+    for (const auto& entry : reports) {
+        const WeightDriftReport& r = entry.second;
+        std::cout << "  " << std::setw(10) << entry.first << ", uint32 nodes: "
+                  << r.bytesPerEdge << " bytes/edge, " << r.routes << " routes, max drift "
+                  << std::setprecision(6) << r.maxAbsoluteDrift << " m (mean "
+                  << r.meanAbsoluteDrift << " m, " << 100.0 * r.maxRelativeDrift << "%), "
+                  << r.reachabilityMismatches << " reachability mismatches\n"
+                  << std::setprecision(2);
+    }
+}
+
+/**
+ * @brief Full single-source trees: Delta-stepping by thread count vs Dijkstra
+ *
+ * Distances must match a full Dijkstra bit for bit. Speedup is reported
+ * against the one-thread Delta-stepping run and against Dijkstra.
+ */
+void benchDeltaStepping(Navigator& navigator, const std::vector<Location*>& locations) {
+    std::cout << "\n[Delta-stepping: full trees by thread count]\n";
+    const CSRGraph<Location*>& csr = navigator.getRoutingGraph();
+    std::vector<Location*> sources;
+    std::mt19937 rng(41);
+    std::uniform_int_distribution<size_t> pick(0, locations.size() - 1);
+    for (int i = 0; i < 5; ++i) {
+        sources.push_back(locations[pick(rng)]);
+    }
+
+    // Reference: one-to-all Dijkstra through distanceMatrix, one source at a time
+    std::vector<std::vector<double>> reference;
+    Clock::time_point t0 = Clock::now();
+    for (Location* source : sources) {
+        std::vector<double> row = navigator.distanceMatrix(std::vector<Location*>(1, source), locations);
+        std::vector<double> byIndex(csr.getNodeCount());
+        for (size_t j = 0; j < locations.size(); ++j) {
+            byIndex[csr.indexOf(locations[j])] = row[j];
+        }
+        reference.push_back(byIndex);
+    }
+    double dijkstraMs = elapsedMs(t0);
+    std::cout << "  Dijkstra: " << dijkstraMs / sources.size() << " ms per tree; auto Delta "
+              << DeltaStepping::autoDelta(csr) << " m\n";
+
+    // 1, 2, 4, ... and finally every hardware thread
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < hardware; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(hardware);
+
+    double single = 0.0;
+    for (unsigned threads : counts) {
+        ThreadPool pool(threads);
+        DeltaStepping search(csr, &pool);
+        int mismatches = 0;
+        t0 = Clock::now();
+        for (size_t i = 0; i < sources.size(); ++i) {
+            search.run(csr.indexOf(sources[i]));
+            std::vector<double> distances = search.distances();
+            if (distances != reference[i]) ++mismatches;
+        }
+        double ms = elapsedMs(t0) / sources.size();
+        if (threads == 1) single = ms;
+        const DeltaStepping::Stats& stats = search.getStats();
+        std::cout << "  " << std::setw(2) << threads << " threads: " << ms << " ms per tree (x"
+                  << single / ms << " vs 1 thread, x" << (dijkstraMs / sources.size()) / ms
+                  << " vs Dijkstra), " << stats.phases << " phases, " << stats.relaxations
+                  << " relaxations, " << mismatches << " mismatches\n";
+    }
+}
+
+/**
+ * @brief Bulk map edit: remove 10% of the nodes from growing graphs
+ *
+ * With the reverse index each removal costs the node's neighbourhood, so
+ * the time per removal should stay flat as the graph grows.
+ */
+void benchGraphEdits() {
+    std::cout << "\n[Graph edits: bulk node removal]\n";
+    const int sides[] = { 50, 100, 200 };
+    for (int side : sides) {
+        SyntheticCampus campus;
+        buildSyntheticCampus(side, campus);
+        Graph<Location*> graph;
+        for (size_t i = 0; i < campus.connections.size(); ++i) {
+            graph.addUndirectedEdge(campus.locations[campus.connections[i].first],
+                                    campus.locations[campus.connections[i].second],
+                                    campus.distances[i]);
+        }
+
+        std::vector<Location*> victims(campus.locations);
+        std::shuffle(victims.begin(), victims.end(), std::mt19937(17));
+        victims.resize(victims.size() / 10);
+
+        Clock::time_point t0 = Clock::now();
+        for (Location* loc : victims) {
+            graph.removeNode(loc);
+        }
+        double ms = elapsedMs(t0);
+        std::cout << "  " << std::setw(6) << campus.locations.size() << " nodes: removed "
+                  << victims.size() << " in " << ms << " ms ("
+                  << 1000.0 * ms / victims.size() << " us each), "
+                  << graph.getEdgeCount() << " edges left\n";
+    }
+}
+
+/**
+ * @brief hasEdge/getEdgeWeight on a hub node, linear scan vs hashed index
+ */
+void benchEdgeLookup() {
+    std::cout << "\n[Edge lookup: hub nodes, scan vs hashed index]\n";
+    const int degrees[] = { 8, 64, 512 };
+    for (int degree : degrees) {
+        Graph<int> graph;
+        for (int hub = 0; hub < 50; ++hub) {
+            for (int k = 1; k <= degree; ++k) {
+                graph.addUndirectedEdge(hub, 1000 + hub * degree + k, 1.0 * k);
+            }
+        }
+        std::mt19937 rng(23);
+        std::uniform_int_distribution<int> hubPick(0, 49);
+        std::uniform_int_distribution<int> spokePick(1, degree + 1);    // +1: some misses
+        std::vector<std::pair<int, int>> pairs;
+        for (int i = 0; i < 200000; ++i) {
+            int hub = hubPick(rng);
+            pairs.push_back(std::make_pair(hub, 1000 + hub * degree + spokePick(rng)));
+        }
+
+        double ms[2];
+        double checksum[2] = { 0.0, 0.0 };
+        for (int indexed = 0; indexed < 2; ++indexed) {
+            graph.setEdgeIndexEnabled(indexed == 1);
+            Clock::time_point t0 = Clock::now();
+            for (const auto& p : pairs) {
+                if (graph.hasEdge(p.first, p.second)) {
+                    checksum[indexed] += graph.getEdgeWeight(p.first, p.second);
+                }
+            }
+            ms[indexed] = elapsedMs(t0);
+        }
+        Clock::time_point t0 = Clock::now();
+        std::vector<double> weights = graph.getEdgeWeights(pairs);
+        double bulkMs = elapsedMs(t0);
+        size_t found = 0;
+        for (double w : weights) {
+            if (w != std::numeric_limits<double>::infinity()) ++found;
+        }
+        std::cout << "  degree " << std::setw(3) << degree << ": " << pairs.size()
+                  << " lookups scan " << ms[0] << " ms, indexed " << ms[1] << " ms, bulk "
+                  << bulkMs << " ms (" << found << " found"
+                  << (checksum[0] == checksum[1] ? "" : ", MISMATCH") << ")\n";
+    }
+}
+
+/**
+ * @brief Temporary closures: incremental table repair vs full rebuild
+ *
+ * Closes and reopens random connections with the table built and the
+ * cache warm. After every change the repaired table is compared with a
+ * fresh build on the same routing graph.
+ */
+void benchClosures() {
+    std::cout << "\n[Connection closures: incremental repair]\n";
+    SyntheticCampus campus;
+    buildSyntheticCampus(40, campus);
+    Navigator navigator;
+    navigator.initializeGraph(campus.locations, campus.connections, campus.distances);
+    navigator.buildAllPairsTable();
+    navigator.setRouteCacheCapacity(1024);
+
+    Clock::time_point t0 = Clock::now();
+    AllPairsTable fresh;
+    fresh.build(navigator.getRoutingGraph());
+    double rebuildMs = elapsedMs(t0);
+
+    std::vector<std::pair<Location*, Location*>> queries = makeQueries(campus.locations, 500);
+    const size_t nodeCount = campus.locations.size();
+    auto matchesFreshBuild = [&]() {
+        fresh.build(navigator.getRoutingGraph());
+        const AllPairsTable& table = navigator.getAllPairsTable();
+        for (uint32_t s = 0; s < nodeCount; ++s) {
+            for (uint32_t t = 0; t < nodeCount; ++t) {
+                double a = table.distance(s, t);
+                double b = fresh.distance(s, t);
+                if (a != b && std::fabs(a - b) > 1e-6) return false;
+            }
+        }
+        return true;
+    };
+
+    std::mt19937 rng(21);
+    std::uniform_int_distribution<size_t> pick(0, campus.connections.size() - 1);
+    const int rounds = 30;
+    double closeMs = 0.0, reopenMs = 0.0;
+    size_t rows = 0, nodes = 0, dropped = 0, kept = 0;
+    int mismatches = 0;
+    for (int i = 0; i < rounds; ++i) {
+        for (const auto& q : queries) {
+            try {
+                navigator.route(q.first, q.second);
+            } catch (const PathNotFoundException&) {
+            }
+        }
+        size_t cachedBefore = navigator.getRouteCacheStats().entries;
+
+        const std::pair<int, int>& edge = campus.connections[pick(rng)];
+        Location* a = campus.locations[edge.first];
+        Location* b = campus.locations[edge.second];
+
+        t0 = Clock::now();
+        ClosureStats closed = navigator.closeConnection(a, b);
+        closeMs += elapsedMs(t0);
+        if (!matchesFreshBuild()) ++mismatches;
+        kept += cachedBefore - closed.routesInvalidated;
+
+        t0 = Clock::now();
+        ClosureStats reopened = navigator.reopenConnection(a, b);
+        reopenMs += elapsedMs(t0);
+        if (!matchesFreshBuild()) ++mismatches;
+
+        rows += closed.table.rowsRepaired + reopened.table.rowsRepaired;
+        nodes += closed.table.nodesResettled + reopened.table.nodesResettled;
+        dropped += closed.routesInvalidated + reopened.routesInvalidated;
+    }
+    std::cout << "  " << nodeCount << " nodes, " << rounds << " close/reopen rounds: full rebuild "
+              << rebuildMs << " ms vs repair " << closeMs / rounds << " ms close, "
+              << reopenMs / rounds << " ms reopen\n";
+    std::cout << "  per change: " << rows / (2 * rounds) << " of " << nodeCount << " rows, "
+              << nodes / (2 * rounds) << " of " << nodeCount * nodeCount << " entries touched\n";
+    std::cout << "  cached routes: " << kept / rounds << " kept, " << dropped / (2 * rounds)
+              << " dropped per change; " << mismatches << " table mismatches vs fresh build\n";
+}
+
+/**
+ * @brief Many threads querying one shared Navigator through route()
+ *
+ * Every thread answers the full query list and compares each distance
+ * with the serial answer; any difference would indicate shared state.
+ */
+void benchConcurrentQueries(const Navigator& navigator,
+                            const std::vector<std::pair<Location*, Location*>>& queries) {
+    std::cout << "\n[Const route() API: concurrent queries on one Navigator]\n";
+    std::vector<double> expected;
+    for (const auto& q : queries) {
+        try {
+            expected.push_back(navigator.route(q.first, q.second).distanceMeters);
+        } catch (const PathNotFoundException&) {
+            expected.push_back(-1.0);
+        }
+    }
+
+    unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+    std::vector<size_t> mismatches(threads, 0);
+    std::vector<std::thread> workers;
+    Clock::time_point t0 = Clock::now();
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.push_back(std::thread([&, t]() {
+            for (size_t i = 0; i < queries.size(); ++i) {
+                double d = -1.0;
+                try {
+                    d = navigator.route(queries[i].first, queries[i].second).distanceMeters;
+                } catch (const PathNotFoundException&) {
+                }
+                if (std::abs(d - expected[i]) > 1e-9) {
+                    ++mismatches[t];
+                }
+            }
+        }));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    size_t total = 0;
+    for (size_t m : mismatches) total += m;
+    std::cout << "  " << threads << " threads x " << queries.size() << " queries: "
+              << elapsedMs(t0) << " ms, " << (total == 0 ? "all results identical" : "MISMATCHES") << "\n";
+}
+
+/**
+ * @brief Batch throughput of findPaths() from 1 to N worker threads
+ *
+ * Mirrors the morning precompute: every "hostel" (first sample) to every
+ * "academic building" (second sample).
+ */
+void benchBatchScaling(Navigator& navigator, const std::vector<Location*>& locations) {
+    std::cout << "\n[Batch findPaths(): throughput vs worker threads]\n";
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<size_t> pick(0, locations.size() - 1);
+    std::vector<std::pair<Location*, Location*>> pairs;
+    for (int h = 0; h < 20; ++h) {
+        Location* hostel = locations[pick(rng)];
+        for (int a = 0; a < 25; ++a) {
+            pairs.push_back({hostel, locations[pick(rng)]});
+        }
+    }
+
+    // 1, 2, 4, ... and finally every hardware thread
+    unsigned maxThreads = std::max(2u, std::thread::hardware_concurrency());
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(maxThreads);
+
+    double baseline = 0.0;
+    for (unsigned threads : counts) {
+        navigator.setThreadCount(threads);
+        navigator.findPaths(std::vector<std::pair<Location*, Location*>>(1, pairs[0]));  // spin up pool
+        Clock::time_point t0 = Clock::now();
+        std::vector<Path> paths = navigator.findPaths(pairs);
+        double ms = elapsedMs(t0);
+        if (threads == 1) baseline = ms;
+        std::cout << "  " << std::setw(2) << threads << " threads: " << ms << " ms, "
+                  << pairs.size() * 1000.0 / ms << " routes/s, speedup x" << baseline / ms << "\n";
+    }
+    std::cout << "  (" << std::thread::hardware_concurrency() << " hardware threads available)\n";
+    navigator.setThreadCount(0);
+}
+
+/**
+ * @brief Kiosk-style workload: a few hot routes asked over and over
+ *
+ * Times the same query stream with and without the route cache, then
+ * edits the graph to show that cached routes expire automatically.
+ */
+void benchRouteCache(Navigator& navigator,
+                     const std::vector<std::pair<Location*, Location*>>& queries) {
+    std::cout << "\n[Route cache: repeated kiosk queries]\n";
+    const size_t hot = std::min<size_t>(20, queries.size());
+    std::vector<std::pair<Location*, Location*>> stream;
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<size_t> pick(0, hot - 1);
+    for (int i = 0; i < 2000; ++i) {
+        stream.push_back(queries[pick(rng)]);
+    }
+
+    auto run = [&]() {
+        Clock::time_point t0 = Clock::now();
+        for (const auto& q : stream) {
+            try {
+                navigator.route(q.first, q.second);
+            } catch (const PathNotFoundException&) {
+            }
+        }
+        return elapsedMs(t0);
+    };
+
+    navigator.setRouteCacheCapacity(0);
+    double uncached = run();
+    navigator.setRouteCacheCapacity(1024);
+    double cached = run();
+    RouteCacheStats stats = navigator.getRouteCacheStats();
+    std::cout << "  " << stream.size() << " queries over " << hot << " routes: "
+              << uncached << " ms uncached, " << cached << " ms cached (x"
+              << uncached / cached << ")\n";
+    std::cout << "  hits " << stats.hits << ", misses " << stats.misses
+              << ", entries " << stats.entries << "\n";
+
+    // A new footpath must not be answered from stale entries
+    Location* a = queries[0].first;
+    Location* b = queries[0].second;
+    double before = navigator.route(a, b).distanceMeters;
+    navigator.addConnection(a, b, 1.0);
+    double after = navigator.route(a, b).distanceMeters;
+    navigator.removeConnection(a, b);
+    double restored = navigator.route(a, b).distanceMeters;
+    stats = navigator.getRouteCacheStats();
+    std::cout << "  after edge add/remove: " << before << " m -> " << after << " m -> "
+              << restored << " m, " << stats.invalidations << " shard invalidations\n";
+    navigator.setRouteCacheCapacity(0);
+}
+
+/**
+ * @brief Multi-stop routes: vias as clicked vs optimized order
+ */
+void benchViaOrder(Navigator& navigator, const std::vector<Location*>& locations) {
+    std::cout << "\n[Via order: as given vs optimized]\n";
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<size_t> pick(0, locations.size() - 1);
+    const size_t counts[] = { 4, 8, 12, 15, 25, 40 };
+    for (size_t count : counts) {
+        std::vector<Location*> stops;
+        while (stops.size() < count + 2) {
+            Location* loc = locations[pick(rng)];
+            if (std::find(stops.begin(), stops.end(), loc) == stops.end()) {
+                stops.push_back(loc);
+            }
+        }
+        Location* start = stops.front();
+        Location* end = stops.back();
+        std::vector<Location*> vias(stops.begin() + 1, stops.end() - 1);
+
+        try {
+            double given = navigator.route(start, end, vias).distanceMeters;
+            Clock::time_point t0 = Clock::now();
+            std::vector<Location*> order = navigator.optimizeViaOrder(start, end, vias);
+            double ms = elapsedMs(t0);
+            double optimized = navigator.route(start, end, order).distanceMeters;
+            std::cout << "  " << std::setw(2) << count << " vias ("
+                      << (count <= ViaOrderOptimizer::HELD_KARP_LIMIT ? "Held-Karp" : "2-opt/Or-opt")
+                      << "): " << given << " m -> " << optimized << " m in " << ms << " ms\n";
+        } catch (const PathNotFoundException&) {
+            std::cout << "  " << std::setw(2) << count << " vias: unreachable stop\n";
+        }
+    }
+}
+
+/**
+ * @brief N x M distances: per-pair route() calls vs distanceMatrix()
+ */
+void benchDistanceMatrix(Navigator& navigator, const std::vector<Location*>& locations) {
+    std::cout << "\n[Distance matrix: per-pair route() vs distanceMatrix()]\n";
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<size_t> pick(0, locations.size() - 1);
+    std::vector<Location*> sources;
+    std::vector<Location*> targets;
+    for (int i = 0; i < 20; ++i) sources.push_back(locations[pick(rng)]);
+    for (int i = 0; i < 50; ++i) targets.push_back(locations[pick(rng)]);
+
+    Clock::time_point t0 = Clock::now();
+    std::vector<double> pairwise;
+    for (Location* s : sources) {
+        for (Location* t : targets) {
+            try {
+                pairwise.push_back(navigator.route(s, t, std::vector<Location*>(),
+                                                   SearchEngine::Dijkstra).distanceMeters);
+            } catch (const PathNotFoundException&) {
+                pairwise.push_back(std::numeric_limits<double>::infinity());
+            }
+        }
+    }
+    double pairMs = elapsedMs(t0);
+
+    t0 = Clock::now();
+    std::vector<double> matrix = navigator.distanceMatrix(sources, targets);
+    double matrixMs = elapsedMs(t0);
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < matrix.size(); ++i) {
+        if (matrix[i] != pairwise[i] && std::abs(matrix[i] - pairwise[i]) > 1e-6) ++mismatches;
+    }
+    std::cout << "  " << sources.size() << " x " << targets.size() << ": " << pairMs
+              << " ms per pair, " << matrixMs << " ms as matrix (x" << pairMs / matrixMs
+              << "), " << (mismatches == 0 ? "identical" : "MISMATCHES") << "\n";
+}
+
+/**
+ * @brief Alternative routes: Yen's k shortest paths vs the penalty method
+ */
+void benchAlternatives(const Navigator& navigator,
+                       const std::vector<std::pair<Location*, Location*>>& queries) {
+    std::cout << "\n[Alternative routes (k = 3): Yen vs penalty method]\n";
+    const size_t count = std::min<size_t>(queries.size(), 50);
+    const AlternativeMethod methods[] = { AlternativeMethod::Yen, AlternativeMethod::Penalty };
+    const char* names[] = { "Yen", "Penalty" };
+    for (int m = 0; m < 2; ++m) {
+        double stretch = 0.0;
+        size_t routes = 0;
+        Clock::time_point t0 = Clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            try {
+                std::vector<Path> paths =
+                    navigator.findAlternatives(queries[i].first, queries[i].second, 3, methods[m]);
+                routes += paths.size();
+                if (paths.front().getTotalDistance() > 0.0) {
+                    stretch += paths.back().getTotalDistance() / paths.front().getTotalDistance();
+                }
+            } catch (const PathNotFoundException&) {
+            }
+        }
+        double ms = elapsedMs(t0);
+        std::cout << "  " << std::setw(8) << names[m] << ": " << ms / count << " ms/query, "
+                  << static_cast<double>(routes) / count << " routes/query, worst/best length x"
+                  << stretch / count << "\n";
+    }
+}
+
+/**
+ * @brief Isochrones: bounded search vs settling the whole graph
+ */
+void benchIsochrone(const Navigator& navigator, const std::vector<Location*>& locations) {
+    std::cout << "\n[Isochrone: reachable within a time budget]\n";
+    const size_t origins = 20;
+    std::vector<Location*> sources;
+    for (size_t i = 0; i < origins; ++i) {
+        sources.push_back(locations[(i * 7919) % locations.size()]);
+    }
+
+    // Baseline: settle the whole graph once per origin (distances do not
+    // depend on the mode), then cut at each budget's distance limit
+    std::map<Location*, size_t> column;
+    for (size_t j = 0; j < locations.size(); ++j) {
+        column[locations[j]] = j;
+    }
+    Clock::time_point t0 = Clock::now();
+    std::vector<std::vector<double>> full;
+    for (Location* source : sources) {
+        full.push_back(navigator.distanceMatrix(std::vector<Location*>(1, source), locations));
+    }
+    std::cout << "  full-graph Dijkstra: " << elapsedMs(t0) / origins << " ms/origin\n";
+
+    WalkingMode walking;
+    CyclingMode cycling;
+    const NavigationMode* modes[] = { &walking, &cycling };
+    const double budgets[] = { 2.0, 5.0, 10.0 };
+    for (const NavigationMode* mode : modes) {
+        for (double minutes : budgets) {
+            std::vector<Isochrone> results;
+            t0 = Clock::now();
+            for (Location* source : sources) {
+                results.push_back(navigator.reachableWithin(source, minutes, *mode));
+            }
+            double ms = elapsedMs(t0);
+
+            // Same nodes as the baseline within the limit, at the same distances
+            size_t reached = 0;
+            size_t mismatches = 0;
+            double limit = 0.0;
+            for (size_t i = 0; i < origins; ++i) {
+                const Isochrone& iso = results[i];
+                limit = iso.distanceLimitMeters;
+                size_t inside = 0;
+                for (double d : full[i]) {
+                    if (d <= limit) ++inside;
+                }
+                if (inside != iso.reachable.size()) ++mismatches;
+                for (const ReachableLocation& r : iso.reachable) {
+                    if (std::abs(full[i][column[r.location]] - r.distanceMeters) > 1e-6) ++mismatches;
+                }
+                reached += iso.reachable.size();
+            }
+            std::cout << "  " << std::setw(8) << mode->getModeName() << " " << std::setw(5)
+                      << minutes << " min (" << limit << " m): " << reached / origins
+                      << " of " << locations.size() << " nodes, "
+                      << ms / origins << " ms, "
+                      << (mismatches == 0 ? "sets match" : "SET MISMATCH") << "\n";
+        }
+    }
+}
+
+/**
+ * @brief Graph-independent sections on an imported OSM network
+ */
+int runOsmBenchmark(const std::string& path, int queryCount) {
+    if (queryCount < 1) {
+        std::cerr << "Usage: CampusBenchmark --osm <extract.osm | extract.osm.pbf> [queries >= 1]\n";
+        return 1;
+    }
+    std::cout << std::fixed << std::setprecision(2);
+
+    SyntheticCampus campus;
+    {
+        OsmNetwork network;
+        OsmImportReport report;
+        try {
+            report = OsmImporter::importFile(path, network);
+        } catch (const OsmFormatException& e) {
+            std::cerr << "OSM import failed: " << e.what() << "\n";
+            return 1;
+        }
+        std::cout << "OSM import: " << report.nodesScanned << " nodes, " << report.waysScanned
+                  << " ways scanned (" << report.blocks << " PBF blocks); " << report.waysKept
+                  << " ways kept, " << report.referencedNodes << " nodes referenced, "
+                  << report.missingNodes << " missing; " << report.droppedLocations
+                  << " locations outside the largest component dropped\n"
+                  << "  ways pass " << report.wayPassMillis << " ms, nodes pass "
+                  << report.nodePassMillis << " ms, build " << report.buildMillis << " ms\n";
+        // Hand the Locations over; SyntheticCampus deletes them
+        campus.locations.swap(network.locations);
+        campus.connections.swap(network.connections);
+        campus.distances.swap(network.distances);
+    }
+    if (campus.locations.size() < 2) {
+        std::cerr << "OSM extract has no routable network\n";
+        return 1;
+    }
+
+    Navigator navigator;
+    Clock::time_point t0 = Clock::now();
+    navigator.initializeGraph(campus.locations, campus.connections, campus.distances);
+    std::cout << "OSM network: " << campus.locations.size() << " nodes, "
+              << navigator.getRoutingGraph().getEdgeCount() << " directed edges ("
+              << elapsedMs(t0) << " ms to build)\n";
+
+    std::vector<std::pair<Location*, Location*>> queries = makeQueries(campus.locations, queryCount);
+    benchGraphLayout(campus, navigator, queries);
+    benchNeighborIteration(navigator, queries);
+    benchEngines(navigator, queries);
+    benchConcurrentQueries(navigator, queries);
+    benchBatchScaling(navigator, campus.locations);
+    benchRouteCache(navigator, queries);
+    benchAlternatives(navigator, queries);
+    benchIsochrone(navigator, campus.locations);
+    benchDial(navigator, queries);
+    benchDeltaStepping(navigator, campus.locations);
+    benchWeightPrecision(navigator, queries);
+    benchSnapshot(campus, navigator, queries);
+    return 0;
+}
+
+} // namespace
+
+/**
+ * @brief Benchmark entry point
+ */
+int main(int argc, char** argv) {
+    if (argc > 2 && std::string(argv[1]) == "--osm") {
+        return runOsmBenchmark(argv[2], argc > 3 ? std::atoi(argv[3]) : 200);
+    }
+    int side = argc > 1 ? std::atoi(argv[1]) : 200;
+    int queryCount = argc > 2 ? std::atoi(argv[2]) : 200;
+    if (side < 2 || queryCount < 1) {
+        std::cerr << "Usage: CampusBenchmark [gridSide >= 2] [queries >= 1]\n";
+        return 1;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+
+    SyntheticCampus campus;
+    Clock::time_point t0 = Clock::now();
+    buildSyntheticCampus(side, campus);
+
+    Navigator navigator;
+    navigator.initializeGraph(campus.locations, campus.connections, campus.distances);
+    std::cout << "Synthetic campus: " << campus.locations.size() << " nodes, "
+              << navigator.getRoutingGraph().getEdgeCount() << " directed edges ("
+              << elapsedMs(t0) << " ms to build)\n";
+
+    std::vector<std::pair<Location*, Location*>> queries = makeQueries(campus.locations, queryCount);
+
+    benchGraphLayout(campus, navigator, queries);
+    benchNeighborIteration(navigator, queries);
+    benchWorkspace(campus, navigator, side, queryCount * 10);
+    benchEngines(navigator, queries);
+    benchConcurrentQueries(navigator, queries);
+    benchBatchScaling(navigator, campus.locations);
+    benchRouteCache(navigator, queries);
+    benchViaOrder(navigator, campus.locations);
+    benchDistanceMatrix(navigator, campus.locations);
+    benchAlternatives(navigator, queries);
+    benchIsochrone(navigator, campus.locations);
+    benchAllPairs();
+    benchClosures();
+    benchQueuePolicies(side);
+    benchDial(navigator, queries);
+    benchDeltaStepping(navigator, campus.locations);
+    benchWeightPrecision(navigator, queries);
+    benchSnapshot(campus, navigator, queries);
+    benchCampusLoader(campus);
+    benchOsmImport(campus);
+    benchGraphEdits();
+    benchEdgeLookup();
+
+    return 0;
+}
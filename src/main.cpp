@@ -4,6 +4,10 @@
  *
  * Initializes campus data, demonstrates OOP features, runs pathfinding
  * tests and launches the SFML GUI.
+ *
+ * Usage: VirtualCampusNavigator [data-file ...]
+ * Each file is CSV or GeoJSON (see CampusDataLoader.h) and may hold
+ * buildings, paths or both. Without files the built-in campus is used.
  */
 
 #include <iostream>
@@ -11,6 +15,7 @@
 #include <memory>
 
 #include "CampusData.h"
+#include "CampusDataLoader.h"
 #include "Location.h"
 #include "AcademicBuilding.h"
 #include "HostelBuilding.h"
@@ -21,14 +26,17 @@
 
 /**
  * @brief Initialize all campus locations
+ * @param buildings Building records (built-in or loaded from files)
+ * @param addTurnNodes Append the hidden turn nodes of the built-in campus
  * @return Vector of location pointers
  */
-std::vector<Location*> initializeLocations() {
+std::vector<Location*> initializeLocations(const std::vector<CampusData::BuildingInfo>& buildings,
+                                           bool addTurnNodes) {
     std::vector<Location*> locations;
 
     // Create location objects from campus data
-    for (size_t i = 0; i < CampusData::BUILDINGS.size(); ++i) {
-        const auto& building = CampusData::BUILDINGS[i];
+    for (size_t i = 0; i < buildings.size(); ++i) {
+        const auto& building = buildings[i];
 
         Location* loc = nullptr;
 
@@ -96,6 +104,10 @@ std::vector<Location*> initializeLocations() {
         locations.push_back(loc);
     }
 
+    if (!addTurnNodes) {
+        return locations;
+    }
+
     // Append turn/waypoint nodes provided by the user (hidden labels)
     // These are not in CampusData::BUILDINGS; they are added at runtime.
     const std::vector<std::tuple<std::string, double, double>> turns = {
@@ -116,7 +128,7 @@ std::vector<Location*> initializeLocations() {
         double lat = std::get<1>(tp);
         double lon = std::get<2>(tp);
 
-        Location* turnLoc = new Location(name, lat, lon, std::string("[hidden]"), static_cast<int>(CampusData::BUILDINGS.size() + t));
+        Location* turnLoc = new Location(name, lat, lon, std::string("[hidden]"), static_cast<int>(buildings.size() + t));
         locations.push_back(turnLoc);
     }
 
@@ -125,8 +137,11 @@ std::vector<Location*> initializeLocations() {
 
 /**
  * @brief Build connection and distance vectors from campus data
+ * @param paths Path records (built-in or loaded from files)
  */
-void buildConnectionData(const std::vector<Location*>& locations, std::vector<std::pair<int, int>>& connections,
+void buildConnectionData(const std::vector<Location*>& locations,
+                        const std::vector<CampusData::PathConnection>& paths,
+                        std::vector<std::pair<int, int>>& connections,
                         std::vector<double>& distances) {
     // Build index map for quick lookup from the runtime locations vector
     std::map<std::string, int> nameToIndex;
@@ -161,8 +176,9 @@ void buildConnectionData(const std::vector<Location*>& locations, std::vector<st
         return R * c;
     };
 
-    // Convert path connections to index pairs based on CampusData::PATHS
-    for (const auto& path : CampusData::PATHS) {
+    // Convert path connections to index pairs
+    size_t unmatched = 0;
+    for (const auto& path : paths) {
         std::string nfrom = normalize(path.from);
         std::string nto = normalize(path.to);
 
@@ -171,7 +187,7 @@ void buildConnectionData(const std::vector<Location*>& locations, std::vector<st
         auto itTo = normToIndex.find(nto);
 
         if (itFrom == normToIndex.end() || itTo == normToIndex.end()) {
-            // not found: skip this path (could log)
+            ++unmatched;
             continue;
         }
 
@@ -191,6 +207,34 @@ void buildConnectionData(const std::vector<Location*>& locations, std::vector<st
         connections.push_back({fromIndex, toIndex});
         distances.push_back(dist);
     }
+    if (unmatched > 0) {
+        std::cerr << "Skipped " << unmatched << " paths naming unknown buildings\n";
+    }
+}
+
+/**
+ * @brief Load buildings and paths from data files
+ * @return False if no building could be loaded
+ */
+bool loadDataFiles(int argc, char** argv,
+                   std::vector<CampusData::BuildingInfo>& buildings,
+                   std::vector<CampusData::PathConnection>& paths) {
+    for (int i = 1; i < argc; ++i) {
+        LoadReport report = CampusDataLoader::loadFile(argv[i], buildings, paths);
+        std::cout << argv[i] << ": " << report.buildings << " buildings, "
+                  << report.paths << " paths, " << report.lines << " lines\n";
+        for (const LoadIssue& issue : report.errors) {
+            std::cerr << argv[i] << ":" << issue.line << ": " << issue.message << "\n";
+        }
+        if (report.errorCount > report.errors.size()) {
+            std::cerr << argv[i] << ": " << (report.errorCount - report.errors.size())
+                      << " more rejected records\n";
+        }
+        if (!report.complete) {
+            std::cerr << argv[i] << ": stopped early, later records were not read\n";
+        }
+    }
+    return !buildings.empty();
 }
 
 /**
@@ -277,7 +321,7 @@ void demonstrateOOPConcepts(const std::vector<Location*>& locations) {
 /**
  * @brief Main function
  */
-int main() {
+int main(int argc, char** argv) {
     std::cout << "========================================\\n";
     std::cout << "Virtual Campus Navigator\\n";
     std::cout << "IIITDM Kancheepuram\\n";
@@ -285,20 +329,48 @@ int main() {
     std::cout << "\\nInitializing campus data...\\n";
     
     try {
+        // Campus data from files given on the command line, else built in
+        std::vector<CampusData::BuildingInfo> buildings;
+        std::vector<CampusData::PathConnection> paths;
+        bool fromFiles = argc > 1;
+        if (fromFiles) {
+            if (!loadDataFiles(argc, argv, buildings, paths)) {
+                std::cerr << "No buildings loaded\n";
+                return 1;
+            }
+        } else {
+            buildings = CampusData::BUILDINGS;
+            paths = CampusData::PATHS;
+        }
+
         // Initialize locations
-        std::vector<Location*> locations = initializeLocations();
+        std::vector<Location*> locations = initializeLocations(buildings, !fromFiles);
         std::cout << "Loaded " << locations.size() << " campus buildings\\n";
         
         // Build connection data
         std::vector<std::pair<int, int>> connections;
         std::vector<double> distances;
-        buildConnectionData(locations, connections, distances);
+        buildConnectionData(locations, paths, connections, distances);
         std::cout << "Loaded " << connections.size() << " path connections\n";
         
-        // Create navigator
+        // Create navigator. The built-in campus (and any similarly small data
+        // file) is small enough to precompute all routes; the O(V^2) table is
+        // skipped for larger files, which use the default engine instead.
+        const size_t maxPrecomputedNodes = 2000;
+        bool precompute = locations.size() <= maxPrecomputedNodes;
         Navigator navigator;
+        navigator.setPrecomputeAllPairs(precompute);
+        navigator.setRouteCacheCapacity(256);
         navigator.initializeGraph(locations, connections, distances);
         std::cout << "Graph initialized successfully\\n";
+        if (precompute) {
+            const AllPairsTable& routeTable = navigator.getAllPairsTable();
+            std::cout << "All-pairs route table: " << routeTable.getMemoryBytes() / 1024
+                      << " KiB, built in " << routeTable.getBuildMillis() << " ms\n";
+        } else {
+            std::cout << "All-pairs route table skipped (" << locations.size()
+                      << " locations > " << maxPrecomputedNodes << ")\n";
+        }
         
         // Demonstrate OOP concepts
         demonstrateOOPConcepts(locations);